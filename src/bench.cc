@@ -0,0 +1,1058 @@
+/* ========================================================================== *
+ *
+ * Micro benchmarks, run with `make bench && LD_LIBRARY_PATH=. ./bench'.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "semver.hh"
+#include "compact.hh"
+#include "view.hh"
+#include "range.hh"
+#include "intern.hh"
+#include "cache.hh"
+#include "catalog.hh"
+#include "rcu.hh"
+#include "compressed.hh"
+#include "stabbing.hh"
+#include "bitset.hh"
+#include "timed.hh"
+#include "sort.hh"
+#include "flat.hh"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <malloc.h>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace semi;
+
+/* -------------------------------------------------------------------------- */
+
+/** Run `fn' `reps' times, returning the best wall time in milliseconds. */
+template <typename Fn>
+  static double
+timeit( size_t reps, Fn && fn )
+{
+  double best = 1e300;
+  for ( size_t i = 0; i < reps; ++i )
+    {
+      const auto start = std::chrono::steady_clock::now();
+      fn();
+      const auto end = std::chrono::steady_clock::now();
+      best = std::min(
+        best, std::chrono::duration<double, std::milli>( end - start ).count()
+      );
+    }
+  return best;
+}
+
+
+/**
+ * Generate `n' version strings shaped like a packument's: mostly releases,
+ * with runs of pre-releases and some build metadata.
+ */
+  static std::vector<std::string>
+versionStrings( size_t n, unsigned seed = 1 )
+{
+  static const char * tags[] = { "alpha", "beta", "rc", "next", "canary" };
+  std::mt19937                       gen( seed );
+  std::uniform_int_distribution<int> part( 0, 30 );
+  std::uniform_int_distribution<int> pct( 0, 99 );
+  std::vector<std::string>           rsl;
+  rsl.reserve( n );
+  for ( size_t i = 0; i < n; ++i )
+    {
+      std::string s = std::to_string( part( gen ) % 8 ) + "." +
+                      std::to_string( part( gen ) ) + "." +
+                      std::to_string( part( gen ) );
+      if ( pct( gen ) < 30 )
+        {
+          s += std::string( "-" ) + tags[part( gen ) % 5] + "." +
+               std::to_string( part( gen ) );
+        }
+      if ( pct( gen ) < 20 )
+        {
+          s += "+build." + std::to_string( part( gen ) );
+        }
+      rsl.push_back( s );
+    }
+  return rsl;
+}
+
+
+  static std::vector<SemVer>
+versions( size_t n, unsigned seed = 1 )
+{
+  std::vector<SemVer> rsl;
+  rsl.reserve( n );
+  for ( const std::string & s : versionStrings( n, seed ) )
+    {
+      rsl.emplace_back( s );
+    }
+  return rsl;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static void
+bench_sort()
+{
+  for ( size_t n : { 5000, 100000, 1000000 } )
+    {
+      const std::vector<SemVer> input = versions( n );
+      const double ms = timeit( 5, [&]() {
+        std::vector<SemVer> vs = input;
+        std::sort( vs.begin(), vs.end()
+                 , []( const SemVer & a, const SemVer & b ) {
+                     return a.compare( b ) < 0;
+                   }
+                 );
+      } );
+      /* Both include copying the input, which is timed on its own. */
+      const double copy = timeit( 5, [&]() {
+        std::vector<SemVer> vs = input;
+      } );
+      const double build = timeit( 5, [&]() {
+        std::vector<SemVer> vs = input;
+        std::stable_sort( vs.begin(), vs.end()
+                        , []( const SemVer & a, const SemVer & b ) {
+                            const char c = a.compare( b );
+                            return ( c != 0 ) ? ( c < 0 )
+                                              : ( a.compareBuild( b ) < 0 );
+                          }
+                        );
+      } );
+      const double radix = timeit( 5, [&]() {
+        std::vector<SemVer> vs = input;
+        semi::sort( vs );
+      } );
+      std::printf( "sort %zu versions with SemVer::compare: %.3f ms"
+                   ", and compareBuild: %.3f ms, semi::sort %.3f ms"
+                   ", copying alone %.3f ms\n"
+                 , n, ms, build, radix, copy
+                 );
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/** Bytes currently allocated from the heap, as reported by glibc. */
+  static size_t
+heapInUse()
+{
+  const struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+
+/** Heap and inline bytes per element of a vector built from `strings'. */
+template <typename T>
+  static double
+bytesPerVersion( const std::vector<std::string> & strings )
+{
+  const size_t before = heapInUse();
+  size_t       after  = 0;
+  {
+    std::vector<T> vs;
+    vs.reserve( strings.size() );
+    for ( const std::string & s : strings )
+      {
+        vs.emplace_back( s );
+      }
+    after = heapInUse();
+  }
+  return double( after - before ) / strings.size();
+}
+
+
+  static void
+bench_memory()
+{
+  const std::vector<std::string> strings = versionStrings( 1000000 );
+  std::printf( "sizeof( SemVer ): %zu, sizeof( CompactSemVer ): %zu\n"
+             , sizeof( SemVer ), sizeof( CompactSemVer )
+             );
+  std::printf( "1M versions, bytes per version: SemVer %.1f"
+               ", CompactSemVer %.1f\n"
+             , bytesPerVersion<SemVer>( strings )
+             , bytesPerVersion<CompactSemVer>( strings )
+             );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/** Parse versions and keep those with a main version below 4.0.0. */
+  static void
+bench_lazy()
+{
+  const std::vector<std::string> strings = versionStrings( 200000 );
+  const SemVer                   limit( "4.0.0" );
+  size_t                         kept  = 0;
+
+  const double eager = timeit( 5, [&]() {
+    kept = 0;
+    for ( const std::string & s : strings )
+      {
+        kept += SemVer( s ).compareMain( limit ) < 0;
+      }
+  } );
+  const double lazy = timeit( 5, [&]() {
+    kept = 0;
+    for ( const std::string & s : strings )
+      {
+        kept += SemVer::parseLazy( s ).compareMain( limit ) < 0;
+      }
+  } );
+  std::printf( "parse and filter %zu versions: eager %.3f ms, lazy %.3f ms\n"
+             , strings.size(), eager, lazy
+             );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/** Sort a canary channel: thousands of pre-releases of one main version. */
+  static void
+bench_prerelease_sort()
+{
+  std::vector<std::string> strings;
+  for ( size_t i = 0; i < 20000; ++i )
+    {
+      strings.push_back( "5.0.0-canary." + std::to_string( i % 5000 ) + "." +
+                         std::to_string( i / 5000 )
+                       );
+    }
+  std::shuffle( strings.begin(), strings.end(), std::mt19937( 3 ) );
+
+  auto sortAll = [&]( const std::vector<SemVer> & input ) {
+    return timeit( 5, [&]() {
+      std::vector<SemVer> vs = input;
+      std::sort( vs.begin(), vs.end()
+               , []( const SemVer & a, const SemVer & b ) {
+                   return a.compare( b ) < 0;
+                 }
+               );
+    } );
+  };
+
+  std::vector<SemVer> eager;
+  std::vector<SemVer> lazy;
+  for ( const std::string & s : strings )
+    {
+      eager.emplace_back( s );
+      lazy.push_back( SemVer::parseLazy( s ) );
+    }
+  std::printf( "sort %zu canaries: decoded identifiers %.3f ms"
+               ", identifier text %.3f ms\n"
+             , strings.size(), sortAll( eager ), sortAll( lazy )
+             );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/** Compare pairs of version strings, as when diffing lockfiles. */
+  static void
+bench_string_compare()
+{
+  const std::vector<std::string> as = versionStrings( 200000, 1 );
+  const std::vector<std::string> bs = versionStrings( 200000, 2 );
+  long                           sum = 0;
+
+  const double construct = timeit( 5, [&]() {
+    for ( size_t i = 0; i < as.size(); ++i )
+      {
+        sum += SemVer( as[i] ).compare( SemVer( bs[i] ) );
+      }
+  } );
+  const double direct = timeit( 5, [&]() {
+    for ( size_t i = 0; i < as.size(); ++i )
+      {
+        sum += semi::compare( as[i], bs[i] ).value_or( 0 );
+      }
+  } );
+  std::printf( "compare %zu string pairs: via SemVer %.3f ms"
+               ", semi::compare %.3f ms\n"
+             , as.size(), construct, direct
+             );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Test versions against a range with several branches, comparing the compiled
+ * intervals to walking every comparator.
+ */
+  static void
+bench_range_test()
+{
+  const std::vector<SemVer> vs    = versions( 200000 );
+  const Range               range(
+    "^1.2.3 || ~2.4.0 || >=3.1.0 <3.5.0 || 4.x || 5.2.1 - 5.9.0 || 7.1.0-rc.1"
+  );
+  long hits = 0;
+
+  const double walk = timeit( 5, [&]() {
+    for ( const SemVer & v : vs )
+      {
+        for ( const std::vector<Comparator> & comps : range.set )
+          {
+            bool ok = true;
+            for ( const Comparator & comp : comps )
+              {
+                ok = ok && comp.test( v );
+              }
+            if ( ok && v.prerelease.empty() )
+              {
+                ++hits;
+                break;
+              }
+          }
+      }
+  } );
+  const double compiled = timeit( 5, [&]() {
+    for ( const SemVer & v : vs )
+      {
+        hits += range.test( v );
+      }
+  } );
+  std::printf( "test %zu versions against a range: comparators %.3f ms"
+               ", intervals %.3f ms\n"
+             , vs.size(), walk, compiled
+             );
+}
+
+
+/** Test one range against a packument's versions, one by one or in columns. */
+  static void
+bench_range_test_columns()
+{
+  const std::vector<SemVer> vs = versions( 200000 );
+  const Range               range(
+    "^1.2.3 || ~2.4.0 || >=3.1.0 <3.5.0 || 4.x || 5.2.1 - 5.9.0 || 7.1.0-rc.1"
+  );
+  VersionColumns columns;
+  for ( const SemVer & v : vs )
+    {
+      columns.push_back( v );
+    }
+  std::vector<uint64_t> matches( columns.maskWords() );
+  long                  hits = 0;
+
+  const double loop = timeit( 5, [&]() {
+    for ( const SemVer & v : vs )
+      {
+        hits += range.test( v );
+      }
+  } );
+  const double batch = timeit( 5, [&]() {
+    range.test( columns, matches );
+    hits += matches[0] & 1;
+  } );
+  std::printf( "test %zu versions against a range: loop %.3f ms"
+               ", columns %.3f ms\n"
+             , vs.size(), loop, batch
+             );
+}
+
+
+/** Pick the highest version of a sorted packument satisfying some ranges. */
+  static void
+bench_max_satisfying()
+{
+  std::vector<SemVer> vs = versions( 20000 );
+  std::sort( vs.begin(), vs.end()
+           , []( const SemVer & a, const SemVer & b )
+             {
+               return a.compare( b ) < 0;
+             }
+           );
+  std::vector<Range> ranges;
+  for ( int i = 0; i < 100; ++i )
+    {
+      ranges.emplace_back( "^" + std::to_string( i % 8 ) + "." +
+                           std::to_string( i % 30 ) + ".0 || ~" +
+                           std::to_string( i % 5 ) + ".3.1-beta.2"
+                         );
+    }
+  size_t found = 0;
+
+  const double linear = timeit( 3, [&]() {
+    for ( const Range & r : ranges )
+      {
+        found += maxSatisfying( vs, r ) != nullptr;
+      }
+  } );
+  const double sorted = timeit( 3, [&]() {
+    for ( const Range & r : ranges )
+      {
+        found += maxSatisfyingSorted( vs, r ) != nullptr;
+      }
+  } );
+  std::printf( "max satisfying of %zu versions for %zu ranges: linear %.3f ms"
+               ", sorted %.3f ms\n"
+             , vs.size(), ranges.size(), linear, sorted
+             );
+}
+
+
+/** Count and pick the latest matches in a catalog, against looping. */
+  static void
+bench_catalog()
+{
+  const std::vector<SemVer> vs = versions( 20000 );
+  const VersionCatalog      catalog( vs );
+  std::vector<Range>        ranges;
+  for ( int i = 0; i < 100; ++i )
+    {
+      ranges.emplace_back( "^" + std::to_string( i % 8 ) + "." +
+                           std::to_string( i % 30 ) + ".0 || ~" +
+                           std::to_string( i % 5 ) + ".3.1-beta.2"
+                         );
+    }
+  size_t found = 0;
+
+  const double loop = timeit( 3, [&]() {
+    for ( const Range & r : ranges )
+      {
+        const SemVer * latest = nullptr;
+        for ( const SemVer & v : vs )
+          {
+            if ( r.test( v ) )
+              {
+                ++found;
+                if ( ( latest == nullptr ) || ( latest->compare( v ) < 0 ) )
+                  {
+                    latest = & v;
+                  }
+              }
+          }
+        found += latest != nullptr;
+      }
+  } );
+  const double indexed = timeit( 3, [&]() {
+    for ( const Range & r : ranges )
+      {
+        found += catalog.count( r ) + ( catalog.latest( r ) != nullptr );
+      }
+  } );
+  std::printf( "count and latest of %zu versions for %zu ranges: loop %.3f ms"
+               ", catalog %.3f ms\n"
+             , vs.size(), ranges.size(), loop, indexed
+             );
+}
+
+
+/** Resolve the latest version of a range as of some time, like `--before'. */
+  static void
+bench_timed_catalog()
+{
+  const std::vector<SemVer>            vs = versions( 20000 );
+  std::vector<TimedCatalog::Published> published;
+  for ( size_t i = 0; i < vs.size(); ++i )
+    {
+      published.push_back( { vs[i], TimedCatalog::Time( i ) } );
+    }
+  const TimedCatalog timed( published );
+  std::vector<Range> ranges;
+  for ( int i = 0; i < 100; ++i )
+    {
+      ranges.emplace_back( "^" + std::to_string( i % 8 ) + "." +
+                           std::to_string( i % 30 ) + ".0 || ~" +
+                           std::to_string( i % 5 ) + ".3.1-beta.2"
+                         );
+    }
+  size_t found = 0;
+
+  const double loop = timeit( 3, [&]() {
+    for ( size_t r = 0; r < ranges.size(); ++r )
+      {
+        const TimedCatalog::Time before = r * 200;
+        const SemVer *           latest = nullptr;
+        for ( const TimedCatalog::Published & p : published )
+          {
+            if ( ( p.time < before ) && ranges[r].test( p.version ) &&
+                 ( ( latest == nullptr ) ||
+                   ( latest->compare( p.version ) < 0 )
+                 )
+               )
+              {
+                latest = & p.version;
+              }
+          }
+        found += latest != nullptr;
+      }
+  } );
+  const double indexed = timeit( 3, [&]() {
+    for ( size_t r = 0; r < ranges.size(); ++r )
+      {
+        found += timed.latest( ranges[r], r * 200 ) != nullptr;
+      }
+  } );
+  std::printf( "latest as of a time among %zu versions for %zu ranges"
+               ": filter %.3f ms, catalog %.3f ms\n"
+             , vs.size(), ranges.size(), loop, indexed
+             );
+}
+
+
+/**
+ * Query a catalog from several readers while a writer keeps publishing,
+ * against guarding a single catalog with a mutex.
+ */
+  static void
+bench_concurrent_catalog()
+{
+  const std::vector<SemVer> vs = versions( 5000 );
+  const Range               range( "^3.4.0 || ~5.1.0" );
+  const size_t              queries = 20000;
+
+  for ( size_t nReaders = 1; nReaders <= 8; nReaders *= 2 )
+    {
+      ConcurrentCatalog concurrent { VersionCatalog( vs ) };
+      VersionCatalog    guarded( vs );
+      std::mutex        mutex;
+      size_t            published[2] = { 0, 0 };
+      double            ms[2]        = { 0, 0 };
+
+      for ( int locked = 0; locked < 2; ++locked )
+        {
+          std::atomic<bool>        done { false };
+          std::vector<std::thread> readers;
+          std::thread writer( [&]() {
+            for ( unsigned i = 0; ! done.load(); ++i )
+              {
+                SemVer v( "9." + std::to_string( i / 1000 ) + "." +
+                          std::to_string( i % 1000 )
+                        );
+                if ( locked )
+                  {
+                    std::lock_guard lock( mutex );
+                    guarded.insert( std::move( v ) );
+                  }
+                else
+                  {
+                    concurrent.insert( std::move( v ) );
+                  }
+                ++published[locked];
+              }
+          } );
+          ms[locked] = timeit( 1, [&]() {
+            for ( size_t t = 0; t < nReaders; ++t )
+              {
+                readers.emplace_back( [&]() {
+                  size_t found = 0;
+                  for ( size_t q = 0; q < queries; ++q )
+                    {
+                      if ( locked )
+                        {
+                          std::lock_guard lock( mutex );
+                          found += guarded.latest( range ) != nullptr;
+                        }
+                      else
+                        {
+                          found += concurrent.snapshot()->latest( range ) !=
+                                   nullptr;
+                        }
+                    }
+                } );
+              }
+            for ( std::thread & reader : readers )
+              {
+                reader.join();
+              }
+          } );
+          done.store( true );
+          writer.join();
+        }
+
+      std::printf( "catalog, %zu readers and a writer: snapshots %.2f M/s"
+                   " (%zu published), mutex %.2f M/s (%zu published)\n"
+                 , nReaders
+                 , nReaders * queries / ms[0] / 1000.0, published[0]
+                 , nReaders * queries / ms[1] / 1000.0, published[1]
+                 );
+    }
+}
+
+
+/** Memory and query time of a compressed catalog, against a plain one. */
+  static void
+bench_compressed_catalog()
+{
+  const std::vector<std::string> strings = versionStrings( 1000000 );
+  std::vector<Range>             ranges;
+  for ( int i = 0; i < 100; ++i )
+    {
+      ranges.emplace_back( "^" + std::to_string( i % 8 ) + "." +
+                           std::to_string( i % 30 ) + ".0 || ~" +
+                           std::to_string( i % 5 ) + ".3.1-beta.2"
+                         );
+    }
+  size_t found = 0;
+
+  size_t before = heapInUse();
+  std::vector<SemVer> vs;
+  vs.reserve( strings.size() );
+  for ( const std::string & s : strings )
+    {
+      vs.emplace_back( s );
+    }
+  const size_t   plainBytes = heapInUse() - before;
+  VersionCatalog catalog( std::move( vs ) );
+
+  before = heapInUse();
+  const CompressedCatalog compressed( catalog );
+  const size_t            compressedBytes = heapInUse() - before;
+
+  const double plain = timeit( 3, [&]() {
+    for ( const Range & r : ranges )
+      {
+        found += catalog.count( r ) + ( catalog.latest( r ) != nullptr );
+      }
+  } );
+  const double packed = timeit( 3, [&]() {
+    for ( const Range & r : ranges )
+      {
+        found += compressed.count( r ) + compressed.latest( r ).has_value();
+      }
+  } );
+  std::printf( "%zu versions, bytes per version: SemVer %.1f"
+               ", compressed %.1f\n"
+             , strings.size(), double( plainBytes ) / strings.size()
+             , double( compressedBytes ) / strings.size()
+             );
+  std::printf( "count and latest for %zu ranges: catalog %.3f ms"
+               ", compressed %.3f ms\n"
+             , ranges.size(), plain, packed
+             );
+}
+
+
+/** Find the dependents accepting new versions, against testing each one. */
+  static void
+bench_range_index()
+{
+  std::mt19937       gen( 20 );
+  std::vector<Range> ranges;
+  for ( int i = 0; i < 100000; ++i )
+    {
+      const std::string v = std::to_string( gen() % 8 ) + "." +
+                            std::to_string( gen() % 30 ) + "." +
+                            std::to_string( gen() % 30 );
+      switch ( i % 4 )
+        {
+          case 0:  ranges.emplace_back( "^" + v );         break;
+          case 1:  ranges.emplace_back( "~" + v );         break;
+          case 2:  ranges.emplace_back( ">=" + v + " <8" ); break;
+          default: ranges.emplace_back( v );               break;
+        }
+    }
+  RangeIndex index;
+  for ( const Range & r : ranges )
+    {
+      index.insert( r );
+    }
+  const std::vector<SemVer> published = versions( 100 );
+  size_t                    found     = 0;
+
+  const double scan = timeit( 3, [&]() {
+    for ( const SemVer & v : published )
+      {
+        for ( const Range & r : ranges )
+          {
+            found += r.test( v );
+          }
+      }
+  } );
+  const double stab = timeit( 3, [&]() {
+    for ( const SemVer & v : published )
+      {
+        found += index.stab( v ).size();
+      }
+  } );
+  std::printf( "ranges accepting %zu versions of %zu: test each %.3f ms"
+               ", index %.3f ms\n"
+             , published.size(), ranges.size(), scan, stab
+             );
+}
+
+
+/** Build an audit's "ranges x versions" matrix, pair by pair and by bitsets. */
+  static void
+bench_catalog_bits()
+{
+  const VersionCatalog catalog( versions( 5000 ) );
+  std::mt19937         gen( 21 );
+  std::vector<Range>   ranges;
+  for ( int i = 0; i < 2000; ++i )
+    {
+      const std::string v = std::to_string( gen() % 8 ) + "." +
+                            std::to_string( gen() % 30 ) + "." +
+                            std::to_string( gen() % 30 );
+      switch ( i % 4 )
+        {
+          case 0:  ranges.emplace_back( "^" + v );                  break;
+          case 1:  ranges.emplace_back( "~" + v + " || >=7.0.0" );  break;
+          case 2:  ranges.emplace_back( ">=" + v + " <8" );         break;
+          default: ranges.emplace_back( v + " - 7.x" );             break;
+        }
+    }
+  size_t found = 0;
+
+  const double pairs = timeit( 3, [&]() {
+    for ( const Range & r : ranges )
+      {
+        for ( const SemVer & v : catalog.versions() )
+          {
+            found += r.test( v );
+          }
+      }
+  } );
+  const double bitsets = timeit( 3, [&]() {
+    CatalogBits bits( catalog );
+    for ( const VersionBits & row : bits.matrix( ranges ) )
+      {
+        found += row.count();
+      }
+  } );
+  std::printf( "matrix of %zu ranges x %zu versions: test pairs %.3f ms"
+               ", bitsets %.3f ms\n"
+             , ranges.size(), catalog.size(), pairs, bitsets
+             );
+}
+
+
+/**
+ * Deduplicate versions and look them up by text, keyed on `toString' as
+ * callers did, against a flat set of the versions themselves.
+ */
+  static void
+bench_flat_set()
+{
+  const std::vector<std::string> strings = versionStrings( 100000 );
+  const std::vector<SemVer>      vs      = versions( 100000 );
+  size_t                         found   = 0;
+
+  std::unordered_map<std::string, SemVer> map;
+  const double mapInsert = timeit( 3, [&]() {
+    map.clear();
+    for ( const SemVer & v : vs )
+      {
+        map.try_emplace( v.toString(), v );
+      }
+  } );
+  const double mapFind = timeit( 3, [&]() {
+    for ( const std::string & s : strings )
+      {
+        /* Keys are normalized, so the text is parsed and rendered. */
+        found += map.count( SemVer( s ).toString() );
+      }
+  } );
+
+  FlatSet<SemVer> set;
+  const double setInsert = timeit( 3, [&]() {
+    set.clear();
+    for ( const SemVer & v : vs )
+      {
+        set.insert( v );
+      }
+  } );
+  const double setFind = timeit( 3, [&]() {
+    for ( const std::string & s : strings )
+      {
+        found += set.contains( std::string_view( s ) );
+      }
+  } );
+  std::printf( "dedupe %zu versions to %zu: by string %.3f ms"
+               ", flat set %.3f ms; find by text: by string %.3f ms"
+               ", flat set %.3f ms\n"
+             , vs.size(), set.size(), mapInsert, setInsert, mapFind, setFind
+             );
+}
+
+
+/** Test ranges against interned versions by rank, against testing versions. */
+  static void
+bench_version_pool()
+{
+  const std::vector<SemVer>    vs = versions( 20000 );
+  VersionPool                  pool;
+  std::vector<VersionPool::Id> ids;
+  for ( const SemVer & v : vs )
+    {
+      ids.push_back( pool.intern( v ) );
+    }
+  std::vector<Range> ranges;
+  for ( int i = 0; i < 100; ++i )
+    {
+      ranges.emplace_back( "^" + std::to_string( i % 8 ) + "." +
+                           std::to_string( i % 30 ) + ".0 || ~" +
+                           std::to_string( i % 5 ) + ".3.1-beta.2"
+                         );
+    }
+  size_t found = 0;
+
+  const double versioned = timeit( 3, [&]() {
+    for ( const Range & r : ranges )
+      {
+        for ( const SemVer & v : vs )
+          {
+            found += r.test( v );
+          }
+      }
+  } );
+  const double ranked = timeit( 3, [&]() {
+    std::vector<VersionPool::Rank> ranks;
+    for ( VersionPool::Id id : ids )
+      {
+        ranks.push_back( pool.rank( id ) );
+      }
+    for ( const Range & r : ranges )
+      {
+        const VersionPool::RankSet set = pool.compile( r );
+        for ( VersionPool::Rank rank : ranks )
+          {
+            found += set.test( rank );
+          }
+      }
+  } );
+  std::printf( "test %zu ranges against %zu versions (%zu distinct)"
+               ": versions %.3f ms, ranks %.3f ms; %zu bytes per version"
+               ", 4 per id\n"
+             , ranges.size(), vs.size(), pool.size(), versioned, ranked
+             , sizeof( SemVer )
+             );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/** Check pairs of ranges for conflicts, as a resolver does for each edge. */
+  static void
+bench_range_intersects()
+{
+  const std::vector<std::string> vs = versionStrings( 2000 );
+  std::vector<Range>             ranges;
+  for ( size_t i = 0; i + 1 < vs.size(); i += 2 )
+    {
+      ranges.emplace_back( "^" + vs[i] + " || ~" + vs[i + 1] );
+    }
+  long hits = 0;
+
+  const double pairs = timeit( 5, [&]() {
+    for ( size_t i = 0; i + 1 < ranges.size(); ++i )
+      {
+        for ( size_t j = i + 1; j < std::min( ranges.size(), i + 50 ); ++j )
+          {
+            hits += ranges[i].intersects( ranges[j] );
+          }
+      }
+  } );
+  std::printf( "intersects over ~%zu range pairs: %.3f ms\n"
+             , ranges.size() * 49, pairs
+             );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/** Combine the ranges of many dependents on one package. */
+  static void
+bench_intersect_all()
+{
+  std::vector<Range> ranges;
+  for ( int i = 0; i < 300; ++i )
+    {
+      ranges.emplace_back( ">=1." + std::to_string( i % 7 ) + ".0 <3 || ~4." +
+                           std::to_string( i % 11 ) + ".0 || 5.x"
+                         );
+    }
+  size_t sets = 0;
+
+  const double pairwise = timeit( 5, [&]() {
+    Range rsl = ranges[0];
+    for ( size_t i = 1; i < ranges.size(); ++i )
+      {
+        rsl = rsl.intersect( ranges[i] );
+      }
+    sets += rsl.set.size();
+  } );
+  const double swept = timeit( 5, [&]() {
+    sets += Range::intersect( ranges ).set.size();
+  } );
+  std::printf( "intersect %zu ranges: pairwise %.3f ms, sweep %.3f ms\n"
+             , ranges.size(), pairwise, swept
+             );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Keep a dependency graph's worth of ranges, written in a handful of ways
+ * each, either as ranges or as interned sets.
+ */
+  static void
+bench_intern()
+{
+  std::vector<std::string> strings;
+  for ( int i = 0; i < 100000; ++i )
+    {
+      const std::string minor = std::to_string( i % 50 );
+      switch ( i % 3 )
+        {
+          case 0:  strings.push_back( "^1." + minor + ".0" );           break;
+          case 1:  strings.push_back( ">=1." + minor + ".0 <2.0.0-0" ); break;
+          default: strings.push_back( "1.x >=1." + minor + ".0" );      break;
+        }
+    }
+
+  size_t before = heapInUse();
+  size_t ranges = 0;
+  {
+    std::vector<Range> kept;
+    kept.reserve( strings.size() );
+    for ( const std::string & s : strings )
+      {
+        kept.emplace_back( s );
+      }
+    ranges = heapInUse() - before;
+  }
+
+  before = heapInUse();
+  size_t interned = 0;
+  size_t distinct = 0;
+  {
+    RangeInterner                                   interner;
+    std::vector<std::shared_ptr<const IntervalSet>> kept;
+    kept.reserve( strings.size() );
+    for ( const std::string & s : strings )
+      {
+        kept.push_back( interner.intern( Range( s ) ) );
+      }
+    interned = heapInUse() - before;
+    distinct = interner.size();
+  }
+
+  std::printf( "%zu ranges, bytes per range: Range %.1f, interned %.1f"
+               " (%zu distinct)\n"
+             , strings.size(), double( ranges ) / strings.size()
+             , double( interned ) / strings.size(), distinct
+             );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Look up a skewed mix of range strings from a growing number of threads,
+ * reporting total lookups per second, against parsing every string.
+ */
+  static void
+bench_range_cache()
+{
+  std::vector<std::string> pool;
+  for ( int i = 0; i < 1000; ++i )
+    {
+      pool.push_back( "^" + std::to_string( i % 20 ) + "." +
+                      std::to_string( i % 17 ) + "." +
+                      std::to_string( i )
+                    );
+    }
+  pool.insert( pool.end(), 3000, "*" );
+  pool.insert( pool.end(), 2000, "^4.17.21" );
+  pool.insert( pool.end(), 1000, "~1.0.0" );
+  std::shuffle( pool.begin(), pool.end(), std::mt19937( 14 ) );
+
+  const size_t perThread = 200000;
+  size_t       sink      = 0;
+
+  const double parsed = timeit( 1, [&]() {
+    for ( size_t i = 0; i < perThread; ++i )
+      {
+        sink += Range( pool[i % pool.size()] ).set.size();
+      }
+  } );
+  std::printf( "parse %zu ranges: %.1f M/s\n"
+             , perThread, perThread / parsed / 1000.0
+             );
+
+  for ( size_t nThreads = 1; nThreads <= 64; nThreads *= 2 )
+    {
+      RangeCache               cache( 4096, 64 );
+      std::vector<size_t>      sets( nThreads, 0 );
+      std::vector<std::thread> threads;
+      const double ms = timeit( 1, [&]() {
+        for ( size_t t = 0; t < nThreads; ++t )
+          {
+            threads.emplace_back( [&, t]() {
+              for ( size_t i = 0; i < perThread; ++i )
+                {
+                  sets[t] += cache.get( pool[( t * 7919 + i ) % pool.size()]
+                                      )->set.size();
+                }
+            } );
+          }
+        for ( std::thread & thread : threads )
+          {
+            thread.join();
+          }
+      } );
+      for ( size_t n : sets )
+        {
+          sink += n;
+        }
+      const RangeCache::Stats stats = cache.stats();
+      std::printf( "range cache, %2zu threads: %.1f M/s, %.2f%% hits\n"
+                 , nThreads, nThreads * perThread / ms / 1000.0
+                 , 100.0 * stats.hits / ( stats.hits + stats.misses )
+                 );
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  int
+main()
+{
+  bench_sort();
+  bench_memory();
+  bench_lazy();
+  bench_prerelease_sort();
+  bench_string_compare();
+  bench_range_test();
+  bench_range_test_columns();
+  bench_max_satisfying();
+  bench_catalog();
+  bench_timed_catalog();
+  bench_concurrent_catalog();
+  bench_compressed_catalog();
+  bench_range_index();
+  bench_catalog_bits();
+  bench_range_intersects();
+  bench_intersect_all();
+  bench_intern();
+  bench_flat_set();
+  bench_version_pool();
+  bench_range_cache();
+  return 0;
+}
+
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,198 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <bit>
+
+#include "bitset.hh"
+#include "interval.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+  void
+VersionBits::set( size_t begin, size_t end )
+{
+  if ( end <= begin )
+    {
+      return;
+    }
+  const size_t first = begin / 64;
+  const size_t last  = ( end - 1 ) / 64;
+  const uint64_t head = ~uint64_t( 0 ) << ( begin % 64 );
+  const uint64_t tail = ~uint64_t( 0 ) >> ( 63 - ( ( end - 1 ) % 64 ) );
+  if ( first == last )
+    {
+      this->words[first] |= head & tail;
+      return;
+    }
+  this->words[first] |= head;
+  std::fill( this->words.begin() + first + 1, this->words.begin() + last
+           , ~uint64_t( 0 )
+           );
+  this->words[last] |= tail;
+}
+
+
+  size_t
+VersionBits::count() const
+{
+  size_t rsl = 0;
+  for ( uint64_t w : this->words )
+    {
+      rsl += std::popcount( w );
+    }
+  return rsl;
+}
+
+
+  std::vector<size_t>
+VersionBits::positions() const
+{
+  std::vector<size_t> rsl;
+  for ( size_t i = 0; i < this->words.size(); ++i )
+    {
+      for ( uint64_t w = this->words[i]; w != 0; w &= w - 1 )
+        {
+          rsl.push_back( ( i * 64 ) + std::countr_zero( w ) );
+        }
+    }
+  return rsl;
+}
+
+
+/* These loops are simple enough for the compiler to vectorize. */
+
+  VersionBits &
+VersionBits::operator&=( const VersionBits & other )
+{
+  for ( size_t i = 0; i < this->words.size(); ++i )
+    {
+      this->words[i] &= other.words[i];
+    }
+  return * this;
+}
+
+
+  VersionBits &
+VersionBits::operator|=( const VersionBits & other )
+{
+  for ( size_t i = 0; i < this->words.size(); ++i )
+    {
+      this->words[i] |= other.words[i];
+    }
+  return * this;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+CatalogBits::CatalogBits( const VersionCatalog & catalog )
+  : catalog( catalog ), releases( catalog.size() )
+{
+  for ( size_t i = 0; i < catalog.size(); ++i )
+    {
+      if ( ( catalog[i].key & 1 ) != 0 )
+        {
+          this->releases.set( i, i + 1 );
+        }
+    }
+}
+
+
+  size_t
+CatalogBits::search( const SemVer & bound ) const
+{
+  const std::span<const SemVer> versions = this->catalog.versions();
+  return std::lower_bound( versions.begin(), versions.end(), bound
+                         , []( const SemVer & a, const SemVer & b )
+                           {
+                             return a.compare( b ) < 0;
+                           }
+                         ) - versions.begin();
+}
+
+
+  void
+CatalogBits::set( VersionBits & bits, const Interval & interval ) const
+{
+  bits.set( this->search( interval.lower )
+          , interval.upper.has_value() ? this->search( * interval.upper )
+                                       : this->catalog.size()
+          );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  const VersionBits &
+CatalogBits::comparator( const Comparator & comp )
+{
+  auto [it, added] = this->comparators.try_emplace( comp.value );
+  if ( added )
+    {
+      it->second = VersionBits( this->catalog.size() );
+      for ( const Interval & i : intervalsOf( comp ) )
+        {
+          this->set( it->second, i );
+        }
+    }
+  return it->second;
+}
+
+
+  VersionBits
+CatalogBits::range( const Range & range, bool includePrerelease )
+{
+  const bool  all = includePrerelease || range.includePrerelease;
+  VersionBits rsl( this->catalog.size() );
+  for ( const std::vector<Comparator> & comps : range.set )
+    {
+      VersionBits matches( this->catalog.size() );
+      matches.set( 0, this->catalog.size() );
+      /* Pre-releases are only allowed in the main versions of pre-release
+       * comparators, as `IntervalSet::compile' allows them. */
+      VersionBits allowed = all ? matches : this->releases;
+      for ( const Comparator & comp : comps )
+        {
+          matches &= this->comparator( comp );
+          if ( ( ! all ) && comp.semver.major.has_value() &&
+               ( ! comp.semver.prereleaseText().empty() )
+             )
+            {
+              this->set( allowed, prereleasesOf( comp.semver ) );
+            }
+        }
+      matches &= allowed;
+      rsl     |= matches;
+    }
+  return rsl;
+}
+
+
+  std::vector<VersionBits>
+CatalogBits::matrix( std::span<const Range> ranges, bool includePrerelease )
+{
+  std::vector<VersionBits> rsl;
+  rsl.reserve( ranges.size() );
+  for ( const Range & r : ranges )
+    {
+      rsl.push_back( this->range( r, includePrerelease ) );
+    }
+  return rsl;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
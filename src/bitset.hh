@@ -0,0 +1,129 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog.hh"
+#include "comparator.hh"
+#include "range.hh"
+#include "semver.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/** A set of positions in a catalog, one bit per version. */
+struct VersionBits {
+
+  std::vector<uint64_t> words;
+  size_t                size = 0;
+
+  VersionBits() = default;
+
+  /** No positions, out of `size'. */
+  explicit VersionBits( size_t size )
+    : words( ( size + 63 ) / 64, 0 ), size( size )
+  {}
+
+    bool
+  test( size_t i ) const
+  {
+    return ( ( this->words[i / 64] >> ( i % 64 ) ) & 1 ) != 0;
+  }
+
+  /** Add the positions from `begin' up to but excluding `end'. */
+  void set( size_t begin, size_t end );
+
+  /** The number of positions, by population count. */
+  size_t count() const;
+
+  /** The positions, in ascending order. */
+  std::vector<size_t> positions() const;
+
+  VersionBits & operator&=( const VersionBits & other );
+  VersionBits & operator|=( const VersionBits & other );
+
+  bool operator==( const VersionBits & other ) const = default;
+
+};  /* End struct `VersionBits' */
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Ranges compiled into bitsets over a fixed catalog, for testing many ranges
+ * against every version at once, as audits building "ranges x versions"
+ * matrices do.
+ *
+ * Each comparator is compiled once into the bitset of the positions it
+ * accepts, by binary searches for its bounds, and cached by its text.
+ * A range is then the "or" of the "and" of its comparator sets' bitsets,
+ * with pre-releases masked out unless allowed, in O( n / 64 ) word
+ * operations per comparator for n versions.
+ *
+ * The catalog must outlive this, and not change.
+ */
+struct CatalogBits {
+
+/* -------------------------------------------------------------------------- */
+
+    explicit CatalogBits( const VersionCatalog & catalog );
+
+    /** The positions of the versions accepted by `comp'. */
+    const VersionBits & comparator( const Comparator & comp );
+
+    /** The positions of the versions accepted by `range', as `Range::test'. */
+    VersionBits range( const Range & range, bool includePrerelease = false );
+
+    /** The positions accepted by each of `ranges', in order. */
+      std::vector<VersionBits>
+    matrix( std::span<const Range> ranges, bool includePrerelease = false );
+
+    /** The number of comparators compiled so far. */
+    size_t cached() const { return this->comparators.size(); }
+
+
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    const VersionCatalog & catalog;
+
+    /** The positions of releases. */
+    VersionBits releases;
+
+    std::unordered_map<std::string, VersionBits> comparators;
+
+    /** The first position at or after `bound'. */
+    size_t search( const SemVer & bound ) const;
+
+    /** Add the positions of `interval' to `bits'. */
+    void set( VersionBits & bits, const Interval & interval ) const;
+
+
+/* -------------------------------------------------------------------------- */
+
+};  /* End struct `CatalogBits' */
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
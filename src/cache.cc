@@ -0,0 +1,208 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+
+#include "cache.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+template <typename T>
+  size_t
+ParseCache<T>::KeyHash::operator()( const KeyView & key ) const
+{
+  return std::hash<std::string_view>()( key.raw ) ^
+         ( static_cast<size_t>( key.flags ) * 0x9e3779b97f4a7c15ULL );
+}
+
+
+template <typename T>
+  size_t
+ParseCache<T>::KeyHash::operator()( const Key & key ) const
+{
+  return ( * this )( KeyView { key.raw, key.flags } );
+}
+
+
+template <typename T>
+  bool
+ParseCache<T>::KeyEqual::operator()( const KeyView & a
+                                   , const KeyView & b
+                                   ) const
+{
+  return ( a.flags == b.flags ) && ( a.raw == b.raw );
+}
+
+
+template <typename T>
+  bool
+ParseCache<T>::KeyEqual::operator()( const Key & a, const KeyView & b ) const
+{
+  return ( * this )( KeyView { a.raw, a.flags }, b );
+}
+
+
+template <typename T>
+  bool
+ParseCache<T>::KeyEqual::operator()( const KeyView & a, const Key & b ) const
+{
+  return ( * this )( a, KeyView { b.raw, b.flags } );
+}
+
+
+template <typename T>
+  bool
+ParseCache<T>::KeyEqual::operator()( const Key & a, const Key & b ) const
+{
+  return ( * this )( KeyView { a.raw, a.flags }, KeyView { b.raw, b.flags } );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+template <typename T>
+ParseCache<T>::ParseCache( size_t capacity, size_t shards )
+  : perShard( 0 ), nShards( shards )
+{
+  if ( ( capacity == 0 ) || ( shards == 0 ) )
+    {
+      throw std::invalid_argument(
+        "A parse cache needs a non-zero capacity and number of shards"
+      );
+    }
+  this->perShard = ( capacity + shards - 1 ) / shards;
+  this->shards   = std::make_unique<Shard[]>( shards );
+  for ( size_t i = 0; i < shards; ++i )
+    {
+      this->shards[i].slots = std::make_unique<Slot[]>( this->perShard );
+      this->shards[i].index.reserve( this->perShard );
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+template <typename T>
+  std::shared_ptr<const T>
+ParseCache<T>::get( std::string_view raw, bool includePrerelease, bool loose )
+{
+  const KeyView key {
+    raw, static_cast<unsigned char>( ( includePrerelease ? 1 : 0 ) |
+                                     ( loose ? 2 : 0 )
+                                   )
+  };
+  Shard & shard = this->shards[KeyHash()( key ) % this->nShards];
+
+  {
+    std::shared_lock lock( shard.mutex );
+    auto             found = shard.index.find( key );
+    if ( found != shard.index.end() )
+      {
+        Slot & slot = shard.slots[found->second];
+        slot.referenced.store( true, std::memory_order_relaxed );
+        shard.hits.fetch_add( 1, std::memory_order_relaxed );
+        return slot.value;
+      }
+  }
+
+  shard.misses.fetch_add( 1, std::memory_order_relaxed );
+  auto value = std::make_shared<const T>( raw, includePrerelease, loose );
+
+  std::unique_lock lock( shard.mutex );
+  /* Another thread may have inserted it while we were parsing. */
+  auto found = shard.index.find( key );
+  if ( found != shard.index.end() )
+    {
+      return shard.slots[found->second].value;
+    }
+
+  size_t idx = shard.used;
+  if ( shard.used < this->perShard )
+    {
+      ++shard.used;
+    }
+  else
+    {
+      /* Give each referenced entry a second chance as the hand passes. */
+      while ( shard.slots[shard.hand].referenced.exchange(
+                false, std::memory_order_relaxed
+              )
+            )
+        {
+          shard.hand = ( shard.hand + 1 ) % this->perShard;
+        }
+      idx        = shard.hand;
+      shard.hand = ( shard.hand + 1 ) % this->perShard;
+      shard.index.erase( shard.slots[idx].key );
+    }
+
+  Slot & slot = shard.slots[idx];
+  slot.key    = Key { std::string( raw ), key.flags };
+  slot.value  = std::move( value );
+  slot.referenced.store( false, std::memory_order_relaxed );
+  shard.index.emplace( slot.key, idx );
+  return slot.value;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+template <typename T>
+  typename ParseCache<T>::Stats
+ParseCache<T>::stats() const
+{
+  Stats rsl { 0, 0, 0 };
+  for ( size_t i = 0; i < this->nShards; ++i )
+    {
+      const Shard & shard = this->shards[i];
+      rsl.hits   += shard.hits.load( std::memory_order_relaxed );
+      rsl.misses += shard.misses.load( std::memory_order_relaxed );
+      std::shared_lock lock( shard.mutex );
+      rsl.size   += shard.index.size();
+    }
+  return rsl;
+}
+
+
+template <typename T>
+  void
+ParseCache<T>::clear()
+{
+  for ( size_t i = 0; i < this->nShards; ++i )
+    {
+      Shard &          shard = this->shards[i];
+      std::unique_lock lock( shard.mutex );
+      shard.index.clear();
+      for ( size_t s = 0; s < shard.used; ++s )
+        {
+          shard.slots[s].key   = Key {};
+          shard.slots[s].value = nullptr;
+        }
+      shard.used = 0;
+      shard.hand = 0;
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+template struct ParseCache<Range>;
+template struct ParseCache<Comparator>;
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,157 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "comparator.hh"
+#include "range.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * A bounded, thread-safe cache of parsed ranges or comparators, keyed by their
+ * string and the `includePrerelease' and `loose' flags they were parsed with.
+ *
+ * Entries are spread across independently locked shards.
+ * Hits only take a shared lock, so concurrent readers never wait on each
+ * other; misses parse outside of any lock and then take the shard's exclusive
+ * lock to insert.
+ * When a shard is full it evicts with the CLOCK algorithm, which
+ * approximates LRU with a "referenced" bit that hits can set without
+ * exclusive access.
+ *
+ * Cached values are immutable and shared, so they stay valid after eviction
+ * for as long as they are referenced.
+ * Strings which fail to parse throw `std::invalid_argument', as the
+ * constructors do, and are not cached.
+ */
+template <typename T>
+struct ParseCache {
+
+/* -------------------------------------------------------------------------- */
+
+    struct Stats {
+      uint64_t hits;
+      uint64_t misses;
+      size_t   size;
+    };
+
+
+/* -------------------------------------------------------------------------- */
+
+    /**
+     * Hold at most `capacity' entries, rounded up to a multiple of `shards'.
+     * Throws `std::invalid_argument' if either is zero.
+     */
+    explicit ParseCache( size_t capacity = 4096, size_t shards = 16 );
+
+    ParseCache( const ParseCache & ) = delete;
+    ParseCache & operator=( const ParseCache & ) = delete;
+
+    /** The value parsed from `raw', parsing and caching it on a miss. */
+      std::shared_ptr<const T>
+    get( std::string_view raw
+       , bool             includePrerelease = false
+       , bool             loose             = false
+       );
+
+    /** Counters summed over all shards, which are not a consistent snapshot. */
+    Stats stats() const;
+
+    /** Drop every entry, leaving the counters as they are. */
+    void clear();
+
+
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    struct Key {
+      std::string   raw;
+      unsigned char flags;
+    };
+
+    struct KeyView {
+      std::string_view raw;
+      unsigned char    flags;
+    };
+
+    /**
+     * Hash and compare owned and borrowed keys alike, so that lookups do not
+     * copy the string.
+     */
+    struct KeyHash {
+      using is_transparent = void;
+      size_t operator()( const KeyView & key ) const;
+      size_t operator()( const Key     & key ) const;
+    };
+
+    struct KeyEqual {
+      using is_transparent = void;
+      bool operator()( const KeyView & a, const KeyView & b ) const;
+      bool operator()( const Key     & a, const KeyView & b ) const;
+      bool operator()( const KeyView & a, const Key     & b ) const;
+      bool operator()( const Key     & a, const Key     & b ) const;
+    };
+
+    struct Slot {
+      Key                      key;
+      std::shared_ptr<const T> value;
+      std::atomic<bool>        referenced { false };
+    };
+
+    /** Aligned to keep shards' locks and counters on separate cache lines. */
+    struct alignas( 64 ) Shard {
+      mutable std::shared_mutex                          mutex;
+      std::unordered_map<Key, size_t, KeyHash, KeyEqual> index;
+      std::unique_ptr<Slot[]>                            slots;
+      size_t                                             used   = 0;
+      size_t                                             hand   = 0;
+      std::atomic<uint64_t>                              hits   { 0 };
+      std::atomic<uint64_t>                              misses { 0 };
+    };
+
+    size_t                   perShard;
+    size_t                   nShards;
+    std::unique_ptr<Shard[]> shards;
+
+
+/* -------------------------------------------------------------------------- */
+
+};  /* End struct `ParseCache' */
+
+
+/* -------------------------------------------------------------------------- */
+
+using RangeCache      = ParseCache<Range>;
+using ComparatorCache = ParseCache<Comparator>;
+
+extern template struct ParseCache<Range>;
+extern template struct ParseCache<Comparator>;
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
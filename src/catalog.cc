@@ -0,0 +1,327 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <algorithm>
+
+#include "catalog.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+VersionCatalog::VersionCatalog( std::vector<SemVer> versions )
+  : sorted( std::move( versions ) )
+{
+  std::stable_sort( this->sorted.begin(), this->sorted.end(), lessVersion );
+  this->reindex();
+}
+
+
+  void
+VersionCatalog::insert( SemVer version )
+{
+  const size_t i = this->search( version, true );
+  const bool   r = ( version.key & 1 ) != 0;
+  this->keys.insert( this->keys.begin() + i, version.key );
+  this->sorted.insert( this->sorted.begin() + i, std::move( version ) );
+  const uint32_t before = this->releasesBefore[i];
+  this->releasesBefore.insert( this->releasesBefore.begin() + i + 1, before );
+  if ( r )
+    {
+      for ( size_t j = i + 1; j < this->releasesBefore.size(); ++j )
+        {
+          ++this->releasesBefore[j];
+        }
+    }
+}
+
+
+  void
+VersionCatalog::insert( std::vector<SemVer> versions )
+{
+  std::stable_sort( versions.begin(), versions.end(), lessVersion );
+  const size_t middle = this->sorted.size();
+  this->sorted.insert( this->sorted.end()
+                     , std::make_move_iterator( versions.begin() )
+                     , std::make_move_iterator( versions.end() )
+                     );
+  std::inplace_merge( this->sorted.begin()
+                    , this->sorted.begin() + middle
+                    , this->sorted.end()
+                    , lessVersion
+                    );
+  this->reindex();
+}
+
+
+  void
+VersionCatalog::reindex()
+{
+  this->keys.resize( this->sorted.size() );
+  this->releasesBefore.resize( this->sorted.size() + 1 );
+  this->releasesBefore[0] = 0;
+  for ( size_t i = 0; i < this->sorted.size(); ++i )
+    {
+      this->keys[i]               = this->sorted[i].key;
+      this->releasesBefore[i + 1] = this->releasesBefore[i] +
+                                    ( this->keys[i] & 1 );
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  size_t
+VersionCatalog::search( const SemVer & bound, bool after ) const
+{
+  const auto lo = std::lower_bound( this->keys.cbegin(), this->keys.cend()
+                                  , bound.key
+                                  );
+  const auto hi = std::upper_bound( lo, this->keys.cend(), bound.key );
+
+  /* Releases are equal if their keys are, while pre-releases of the same
+   * main version are ordered by their identifiers. */
+  if ( ( bound.key & 1 ) != 0 )
+    {
+      return ( after ? hi : lo ) - this->keys.cbegin();
+    }
+  const auto first = this->sorted.cbegin() + ( lo - this->keys.cbegin() );
+  const auto last  = this->sorted.cbegin() + ( hi - this->keys.cbegin() );
+  return ( after ? std::upper_bound( first, last, bound, lessVersion )
+                 : std::lower_bound( first, last, bound, lessVersion )
+         ) - this->sorted.cbegin();
+}
+
+
+  size_t
+VersionCatalog::nextRelease( size_t i ) const
+{
+  /* The release at index j is the one after which the count first exceeds
+   * the count before `i'. */
+  const auto j = std::upper_bound( this->releasesBefore.cbegin() + i + 1
+                                 , this->releasesBefore.cend()
+                                 , this->releasesBefore[i]
+                                 );
+  return ( j == this->releasesBefore.cend() )
+         ? this->size()
+         : ( j - this->releasesBefore.cbegin() - 1 );
+}
+
+
+  size_t
+VersionCatalog::prevRelease( size_t i ) const
+{
+  if ( this->releasesBefore[i] == 0 )
+    {
+      return this->size();
+    }
+  const auto j = std::lower_bound( this->releasesBefore.cbegin()
+                                 , this->releasesBefore.cbegin() + i + 1
+                                 , this->releasesBefore[i]
+                                 );
+  return j - this->releasesBefore.cbegin() - 1;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  std::vector<VersionCatalog::Segment>
+VersionCatalog::segmentsOf(
+  const Range                                     & range
+,       bool                                        includePrerelease
+,       size_t                                      size
+, const std::function<size_t( const SemVer & )>   & search
+)
+{
+  const IntervalSet &  set = range.compiled;
+  std::vector<Segment> rsl;
+  auto push = [&]( size_t begin, size_t end, bool releasesOnly )
+    {
+      if ( begin < end )
+        {
+          rsl.push_back( Segment { begin, end, releasesOnly } );
+        }
+    };
+
+  const bool all = includePrerelease || range.includePrerelease;
+  auto       pre = set.prerelease.cbegin();
+  for ( const Interval & i : set.intervals )
+    {
+      size_t       begin = search( i.lower );
+      const size_t end   = i.upper.has_value() ? search( * i.upper ) : size;
+      if ( all )
+        {
+          push( begin, end, false );
+          continue;
+        }
+
+      /* Allowances are subsets of the intervals, so each one lies within
+       * the first interval whose upper bound is above its lower bound. */
+      while ( ( pre != set.prerelease.cend() ) &&
+              ( ( ! i.upper.has_value() ) ||
+                ( pre->lower.compare( * i.upper ) < 0 )
+              )
+            )
+        {
+          const size_t preBegin = search( pre->lower );
+          const size_t preEnd   = pre->upper.has_value()
+                                  ? search( * pre->upper )
+                                  : size;
+          push( begin, preBegin, true );
+          push( preBegin, preEnd, false );
+          begin = std::max( begin, preEnd );
+          ++pre;
+        }
+      push( begin, end, true );
+    }
+  return rsl;
+}
+
+
+  std::vector<VersionCatalog::Segment>
+VersionCatalog::segments( const Range & range, bool includePrerelease ) const
+{
+  return segmentsOf( range, includePrerelease, this->size()
+                   , [this]( const SemVer & bound )
+                     {
+                       return this->search( bound );
+                     }
+                   );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  VersionCatalog::Matches
+VersionCatalog::match( const Range & range, bool includePrerelease ) const
+{
+  return Matches { this, this->segments( range, includePrerelease ) };
+}
+
+
+  const SemVer *
+VersionCatalog::latest( const Range & range, bool includePrerelease ) const
+{
+  const std::vector<Segment> segments =
+    this->segments( range, includePrerelease );
+  for ( auto s = segments.crbegin(); s != segments.crend(); ++s )
+    {
+      size_t last = s->end - 1;
+      if ( s->releasesOnly )
+        {
+          last = this->prevRelease( s->end );
+          if ( ( last == this->size() ) || ( last < s->begin ) )
+            {
+              continue;
+            }
+        }
+      return & this->sorted[this->search( this->sorted[last] )];
+    }
+  return nullptr;
+}
+
+
+  const SemVer *
+VersionCatalog::earliest( const Range & range, bool includePrerelease ) const
+{
+  for ( const Segment & s : this->segments( range, includePrerelease ) )
+    {
+      const size_t first = s.releasesOnly ? this->nextRelease( s.begin )
+                                          : s.begin;
+      if ( first < s.end )
+        {
+          return & this->sorted[first];
+        }
+    }
+  return nullptr;
+}
+
+
+  size_t
+VersionCatalog::count( const Range & range, bool includePrerelease ) const
+{
+  return this->match( range, includePrerelease ).size();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  const SemVer &
+VersionCatalog::Matches::iterator::operator*() const
+{
+  return this->matches->catalog->sorted[this->index];
+}
+
+
+  void
+VersionCatalog::Matches::iterator::settle()
+{
+  const std::vector<Segment> & segments = this->matches->segments;
+  while ( this->segment < segments.size() )
+    {
+      const Segment & s = segments[this->segment];
+      if ( s.releasesOnly && ( this->index < s.end ) )
+        {
+          this->index = this->matches->catalog->nextRelease( this->index );
+        }
+      if ( this->index < s.end )
+        {
+          return;
+        }
+      if ( ++this->segment < segments.size() )
+        {
+          this->index = segments[this->segment].begin;
+        }
+    }
+  this->index = 0;
+}
+
+
+  VersionCatalog::Matches::iterator &
+VersionCatalog::Matches::iterator::operator++()
+{
+  ++this->index;
+  this->settle();
+  return * this;
+}
+
+
+  VersionCatalog::Matches::iterator
+VersionCatalog::Matches::begin() const
+{
+  if ( this->segments.empty() )
+    {
+      return this->end();
+    }
+  iterator rsl { this, 0, this->segments.front().begin };
+  rsl.settle();
+  return rsl;
+}
+
+
+  size_t
+VersionCatalog::Matches::size() const
+{
+  const std::vector<uint32_t> & releases = this->catalog->releasesBefore;
+  size_t                        rsl      = 0;
+  for ( const Segment & s : this->segments )
+    {
+      rsl += s.releasesOnly ? ( releases[s.end] - releases[s.begin] )
+                            : ( s.end - s.begin );
+    }
+  return rsl;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
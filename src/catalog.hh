@@ -0,0 +1,202 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "range.hh"
+#include "semver.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * All published versions of a package, sorted in `SemVer::compare' order and
+ * indexed for range queries.
+ *
+ * Versions are searched by their packed `VersionKey', only comparing
+ * pre-release identifiers among versions of the same main version.
+ * A running count of releases lets queries step over versions which are
+ * not allowed, so that latest, earliest, and count take O( k log n ) time
+ * for a range of k intervals, and iterating takes O( log n ) per match.
+ *
+ * Equal versions, which differ only in build metadata, are kept in the order
+ * they were added.
+ */
+struct VersionCatalog {
+
+/* -------------------------------------------------------------------------- */
+
+    /** A run of versions, of which either all or only releases match. */
+    struct Segment {
+      size_t begin;
+      size_t end;
+      bool   releasesOnly;
+    };
+
+    /**
+     * A view of the versions in a catalog matching a range, which is
+     * invalidated by adding versions to the catalog.
+     */
+    struct Matches {
+
+      struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = SemVer;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const SemVer *;
+        using reference         = const SemVer &;
+
+        const Matches * matches;
+        size_t          segment;
+        size_t          index;
+
+        reference operator*()  const;
+        pointer   operator->() const { return & ** this; }
+
+        iterator & operator++();
+
+          iterator
+        operator++( int )
+        {
+          iterator tmp = * this;
+          ++( * this );
+          return tmp;
+        }
+
+          bool
+        operator==( const iterator & other ) const
+        {
+          return ( this->segment == other.segment ) &&
+                 ( this->index == other.index );
+        }
+
+        /** Move to the next match at or after the current position. */
+        void settle();
+      };
+
+      const VersionCatalog * catalog;
+      std::vector<Segment>   segments;
+
+      iterator begin() const;
+      iterator end()   const { return { this, this->segments.size(), 0 }; }
+
+      /** The number of matches, in O( k ) time for k segments. */
+      size_t size()  const;
+      bool   empty() const { return this->begin() == this->end(); }
+
+    };  /* End struct `Matches' */
+
+
+/* -------------------------------------------------------------------------- */
+
+    VersionCatalog() = default;
+
+    /** Bulk load versions in any order, sorting them once. */
+    explicit VersionCatalog( std::vector<SemVer> versions );
+
+    /** Add one version, after any equal ones, in O( n ) time. */
+    void insert( SemVer version );
+
+    /** Add many versions at once, merging them in O( n + m log m ) time. */
+    void insert( std::vector<SemVer> versions );
+
+    size_t size()  const { return this->sorted.size(); }
+    bool   empty() const { return this->sorted.empty(); }
+
+    const SemVer & operator[]( size_t i ) const { return this->sorted[i]; }
+
+    /** Every version, in ascending order. */
+    std::span<const SemVer> versions() const { return this->sorted; }
+
+
+/* -------------------------------------------------------------------------- */
+
+    /* Queries, accepting versions as `Range::test' does. */
+
+    /** The versions accepted by `range', in ascending order. */
+    Matches match( const Range & range, bool includePrerelease = false ) const;
+
+    /**
+     * The highest version accepted by `range', or `nullptr' if there is none.
+     * The first of equal versions is returned, as `maxSatisfying' does.
+     */
+      const SemVer *
+    latest( const Range & range, bool includePrerelease = false ) const;
+
+    /** The lowest version accepted by `range', or `nullptr'. */
+      const SemVer *
+    earliest( const Range & range, bool includePrerelease = false ) const;
+
+    /** The number of versions accepted by `range'. */
+    size_t count( const Range & range, bool includePrerelease = false ) const;
+
+    /**
+     * Split a sorted list of `size' versions into the segments accepted by
+     * `range', as `Range::test' does with `includePre', where
+     * `search( bound )' is the index of the first version at or after
+     * `bound'.
+     * This is shared with other catalogs' encodings.
+     */
+      static std::vector<Segment>
+    segmentsOf( const Range                                   & range
+              ,       bool                                      includePre
+              ,       size_t                                    size
+              , const std::function<size_t( const SemVer & )> & search
+              );
+
+
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    std::vector<SemVer>     sorted;
+    std::vector<VersionKey> keys;
+
+    /** The number of releases before each index, with one for the end. */
+    std::vector<uint32_t> releasesBefore = { 0 };
+
+    /** Rebuild `keys' and `releasesBefore' from `sorted'. */
+    void reindex();
+
+    /** The first index at or after `bound', or after it if `after'. */
+    size_t search( const SemVer & bound, bool after = false ) const;
+
+    /** The first release at or after `i', or `size()' if there is none. */
+    size_t nextRelease( size_t i ) const;
+
+    /** The last release before `i', or `size()' if there is none. */
+    size_t prevRelease( size_t i ) const;
+
+    std::vector<Segment> segments( const Range & range
+                                 ,       bool    includePrerelease
+                                 ) const;
+
+
+
+/* -------------------------------------------------------------------------- */
+
+};  /* End struct `VersionCatalog' */
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,387 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#  include <immintrin.h>
+#  define SEMI_HAVE_AVX2 1
+#endif
+
+#include "columns.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+  void
+VersionColumns::push_back( const SemVer & version )
+{
+  this->major.push_back( version.major.value_or( 0 ) );
+  this->minor.push_back( version.minor.value_or( 0 ) );
+  this->patch.push_back( version.patch.value_or( 0 ) );
+  const std::string_view tag = version.prereleaseText();
+  this->prerelease.push_back( tag.empty() ? 0 : 1 );
+  this->tags.emplace_back( tag );
+}
+
+
+  void
+VersionColumns::push_back( const SemVerView & version )
+{
+  this->major.push_back( version.major() );
+  this->minor.push_back( version.minor() );
+  this->patch.push_back( version.patch() );
+  this->prerelease.push_back( version.parts.prerelease.empty() ? 0 : 1 );
+  this->tags.emplace_back( version.parts.prerelease );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * An interval bound split into columns' units.
+ * Within a main version, a bound's `rank' orders it against a version whose
+ * rank is 1 for pre-releases and 2 for releases: a release bound is 2, and a
+ * pre-release bound is 1, or 0 for "-0" which precedes every pre-release.
+ * Versions and bounds which are both of rank 1 are ordered by identifiers.
+ */
+struct Bound {
+  uint32_t       major;
+  uint32_t       minor;
+  uint32_t       patch;
+  int32_t        rank;
+  const SemVer * version;
+};
+
+struct Span {
+  Bound lower;
+  Bound upper;
+  bool  bounded;
+};
+
+
+  static Bound
+boundOf( const SemVer & version )
+{
+  const VersionKey       key = version.key;
+  const std::string_view tag = version.prereleaseText();
+  return Bound {
+    static_cast<uint32_t>( key >> 65 )
+  , static_cast<uint32_t>( key >> 33 )
+  , static_cast<uint32_t>( key >> 1 )
+  , tag.empty() ? 2 : ( ( tag == "0" ) ? 0 : 1 )
+  , & version
+  };
+}
+
+
+  static std::vector<Span>
+spansOf( const std::vector<Interval> & intervals )
+{
+  std::vector<Span> rsl;
+  rsl.reserve( intervals.size() );
+  for ( const Interval & i : intervals )
+    {
+      rsl.push_back( Span {
+        boundOf( i.lower )
+      , i.upper.has_value() ? boundOf( * i.upper ) : Bound {}
+      , i.upper.has_value()
+      } );
+    }
+  return rsl;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/** Order version `i' of `versions' against `bound' exactly. */
+  static char
+compareLane( const VersionColumns & versions, size_t i, const Bound & bound )
+{
+  const uint32_t a[3] = {
+    versions.major[i], versions.minor[i], versions.patch[i]
+  };
+  const uint32_t b[3] = { bound.major, bound.minor, bound.patch };
+  for ( size_t p = 0; p < 3; ++p )
+    {
+      if ( a[p] != b[p] )
+        {
+          return ( a[p] < b[p] ) ? -1 : 1;
+        }
+    }
+  return compareIdentifierLists( versions.tags[i]
+                               , bound.version->prereleaseText()
+                               );
+}
+
+
+/** Whether version `i' is in any of `spans', by binary search. */
+  static bool
+laneIn( const std::vector<Span>    & spans
+      , const VersionColumns       & versions
+      ,       size_t                 i
+      )
+{
+  auto after = std::upper_bound(
+    spans.cbegin(), spans.cend(), i
+  , [&]( size_t lane, const Span & span )
+    {
+      return compareLane( versions, lane, span.lower ) < 0;
+    }
+  );
+  if ( after == spans.cbegin() )
+    {
+      return false;
+    }
+  const Span & span = * std::prev( after );
+  return ( ! span.bounded ) || ( compareLane( versions, i, span.upper ) < 0 );
+}
+
+
+  static bool
+testLane( const std::vector<Span>    & spans
+        , const std::vector<Span>    & prereleases
+        , const VersionColumns       & versions
+        ,       size_t                 i
+        ,       bool                   includePrerelease
+        )
+{
+  return ( includePrerelease || ( versions.prerelease[i] == 0 ) )
+         ? laneIn( spans, versions, i )
+         : laneIn( prereleases, versions, i );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef SEMI_HAVE_AVX2
+
+/** Versions' columns loaded eight at a time, biased for signed compares. */
+struct Lanes {
+  __m256i major;
+  __m256i minor;
+  __m256i patch;
+  __m256i rank;
+};
+
+
+/**
+ * Which lanes are at or after `bound', in `ge', and which are pre-releases
+ * of the same main version as a pre-release bound, in `tie', whose order
+ * depends on their identifiers.
+ */
+__attribute__(( target( "avx2" ) ))
+  static inline void
+compareBound( const Lanes & lanes
+            , const Bound & bound
+            ,       __m256i & ge
+            ,       __m256i & tie
+            )
+{
+  const __m256i bias  = _mm256_set1_epi32( INT32_MIN );
+  const __m256i major = _mm256_xor_si256(
+    _mm256_set1_epi32( static_cast<int32_t>( bound.major ) ), bias
+  );
+  const __m256i minor = _mm256_xor_si256(
+    _mm256_set1_epi32( static_cast<int32_t>( bound.minor ) ), bias
+  );
+  const __m256i patch = _mm256_xor_si256(
+    _mm256_set1_epi32( static_cast<int32_t>( bound.patch ) ), bias
+  );
+  const __m256i eqMajor = _mm256_cmpeq_epi32( lanes.major, major );
+  const __m256i eqMinor = _mm256_cmpeq_epi32( lanes.minor, minor );
+  const __m256i eqPatch = _mm256_cmpeq_epi32( lanes.patch, patch );
+  const __m256i geRank  = _mm256_cmpgt_epi32(
+    lanes.rank, _mm256_set1_epi32( bound.rank - 1 )
+  );
+
+  __m256i rsl = _mm256_or_si256( _mm256_cmpgt_epi32( lanes.patch, patch )
+                               , _mm256_and_si256( eqPatch, geRank )
+                               );
+  rsl = _mm256_or_si256( _mm256_cmpgt_epi32( lanes.minor, minor )
+                       , _mm256_and_si256( eqMinor, rsl )
+                       );
+  ge  = _mm256_or_si256( _mm256_cmpgt_epi32( lanes.major, major )
+                       , _mm256_and_si256( eqMajor, rsl )
+                       );
+
+  if ( bound.rank == 1 )
+    {
+      tie = _mm256_and_si256(
+        _mm256_and_si256( _mm256_and_si256( eqMajor, eqMinor ), eqPatch )
+      , _mm256_cmpeq_epi32( lanes.rank, _mm256_set1_epi32( 1 ) )
+      );
+    }
+  else
+    {
+      tie = _mm256_setzero_si256();
+    }
+}
+
+
+/** Lanes within any of `spans', and lanes which need an exact test. */
+__attribute__(( target( "avx2" ) ))
+  static inline void
+spansIn( const Lanes             & lanes
+       , const std::vector<Span> & spans
+       ,       __m256i           & in
+       ,       __m256i           & ambiguous
+       )
+{
+  in        = _mm256_setzero_si256();
+  ambiguous = _mm256_setzero_si256();
+  for ( const Span & span : spans )
+    {
+      __m256i geLower;
+      __m256i tieLower;
+      compareBound( lanes, span.lower, geLower, tieLower );
+      __m256i within = geLower;
+      if ( span.bounded )
+        {
+          __m256i geUpper;
+          __m256i tieUpper;
+          compareBound( lanes, span.upper, geUpper, tieUpper );
+          within    = _mm256_andnot_si256( geUpper, geLower );
+          ambiguous = _mm256_or_si256( ambiguous, tieUpper );
+        }
+      in        = _mm256_or_si256( in, within );
+      ambiguous = _mm256_or_si256( ambiguous, tieLower );
+    }
+}
+
+
+/** Test versions eight at a time, up to the last full block of eight. */
+__attribute__(( target( "avx2" ) ))
+  static size_t
+testAvx2( const std::vector<Span>    & spans
+        , const std::vector<Span>    & prereleases
+        , const VersionColumns       & versions
+        ,       uint64_t             * matches
+        ,       bool                   includePrerelease
+        )
+{
+  const size_t  end  = versions.size() - ( versions.size() % 8 );
+  const __m256i bias = _mm256_set1_epi32( INT32_MIN );
+  const __m256i two  = _mm256_set1_epi32( 2 );
+  for ( size_t i = 0; i < end; i += 8 )
+    {
+      Lanes lanes;
+      lanes.major = _mm256_xor_si256(
+        _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>( versions.major.data() + i )
+        )
+      , bias
+      );
+      lanes.minor = _mm256_xor_si256(
+        _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>( versions.minor.data() + i )
+        )
+      , bias
+      );
+      lanes.patch = _mm256_xor_si256(
+        _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>( versions.patch.data() + i )
+        )
+      , bias
+      );
+      const __m256i isPre = _mm256_cvtepu8_epi32( _mm_loadl_epi64(
+        reinterpret_cast<const __m128i *>( versions.prerelease.data() + i )
+      ) );
+      lanes.rank = _mm256_sub_epi32( two, isPre );
+
+      __m256i in;
+      __m256i ambiguous;
+      spansIn( lanes, spans, in, ambiguous );
+      if ( ! includePrerelease )
+        {
+          __m256i preIn;
+          __m256i preAmbiguous;
+          spansIn( lanes, prereleases, preIn, preAmbiguous );
+          const __m256i pre = _mm256_cmpeq_epi32( isPre
+                                                , _mm256_set1_epi32( 1 )
+                                                );
+          in        = _mm256_blendv_epi8( in, preIn, pre );
+          ambiguous = _mm256_blendv_epi8( ambiguous, preAmbiguous, pre );
+        }
+
+      uint64_t bits = static_cast<uint32_t>(
+        _mm256_movemask_ps( _mm256_castsi256_ps( in ) )
+      );
+      uint32_t unsure = static_cast<uint32_t>(
+        _mm256_movemask_ps( _mm256_castsi256_ps( ambiguous ) )
+      );
+      while ( unsure != 0 )
+        {
+          const unsigned lane = __builtin_ctz( unsure );
+          unsure &= unsure - 1;
+          bits   &= ~( uint64_t( 1 ) << lane );
+          if ( testLane( spans, prereleases, versions, i + lane
+                       , includePrerelease
+                       )
+             )
+            {
+              bits |= uint64_t( 1 ) << lane;
+            }
+        }
+      matches[i / 64] |= bits << ( i % 64 );
+    }
+  return end;
+}
+
+#endif  /* SEMI_HAVE_AVX2 */
+
+
+/* -------------------------------------------------------------------------- */
+
+  void
+testColumns( const IntervalSet          & set
+           , const VersionColumns       & versions
+           ,       std::span<uint64_t>    matches
+           ,       bool                   includePrerelease
+           )
+{
+  if ( matches.size() < versions.maskWords() )
+    {
+      throw std::invalid_argument(
+        "Mask of " + std::to_string( matches.size() ) + " words is too " +
+        "small for " + std::to_string( versions.size() ) + " versions"
+      );
+    }
+  std::fill( matches.begin(), matches.end(), 0 );
+
+  const std::vector<Span> spans       = spansOf( set.intervals );
+  const std::vector<Span> prereleases = spansOf( set.prerelease );
+
+  size_t begin = 0;
+#ifdef SEMI_HAVE_AVX2
+  if ( __builtin_cpu_supports( "avx2" ) )
+    {
+      begin = testAvx2( spans, prereleases, versions, matches.data()
+                      , includePrerelease
+                      );
+    }
+#endif
+  for ( size_t i = begin; i < versions.size(); ++i )
+    {
+      if ( testLane( spans, prereleases, versions, i, includePrerelease ) )
+        {
+          matches[i / 64] |= uint64_t( 1 ) << ( i % 64 );
+        }
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,85 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "interval.hh"
+#include "semver.hh"
+#include "view.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Versions laid out column by column, so that many of them can be tested
+ * against a range at once with SIMD instructions.
+ *
+ * Most versions are decided by their main version and whether they are a
+ * pre-release.
+ * The pre-release identifiers in `tags' are only consulted for the few
+ * pre-releases sharing a main version with a pre-release bound.
+ */
+struct VersionColumns {
+
+  std::vector<uint32_t> major;
+  std::vector<uint32_t> minor;
+  std::vector<uint32_t> patch;
+
+  /** 1 for pre-release versions, and 0 for releases. */
+  std::vector<uint8_t> prerelease;
+
+  /** Dot separated pre-release identifiers, empty for releases. */
+  std::vector<std::string> tags;
+
+  void push_back( const SemVer     & version );
+  void push_back( const SemVerView & version );
+
+  size_t size() const { return this->major.size(); }
+
+  /** The number of 64 bit words in a mask of matches for every version. */
+  size_t maskWords() const { return ( this->size() + 63 ) / 64; }
+
+};  /* End struct `VersionColumns' */
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Test every version in `versions' against `set', as `IntervalSet::test'
+ * does, setting bit i % 64 of `matches[i / 64]' if version i is accepted.
+ * Bits past the last version are cleared.
+ *
+ * Uses AVX2 where the CPU supports it, testing eight versions at a time,
+ * and falls back to testing them one by one.
+ * Throws `std::invalid_argument' if `matches' has fewer than
+ * `versions.maskWords()' words.
+ */
+void testColumns( const IntervalSet          & set
+                , const VersionColumns       & versions
+                ,       std::span<uint64_t>    matches
+                ,       bool                   includePrerelease
+                );
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
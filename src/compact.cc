@@ -0,0 +1,277 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "compact.hh"
+#include "scan.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+  /** Join identifiers with dots. */
+    static std::string
+  joinIdentifiers( const std::vector<std::string> & ids )
+  {
+    std::string rsl;
+    for ( auto i = ids.cbegin(); i != ids.cend(); ++i )
+      {
+        if ( i != ids.cbegin() )
+          {
+            rsl += '.';
+          }
+        rsl += *i;
+      }
+    return rsl;
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+  CompactSemVer::CompactSemVer( std::string_view version, bool loose )
+  {
+    SemVerParts parts;
+    if ( ! scanSemVer( version, loose, parts ) )
+      {
+        throw std::invalid_argument(
+          "Invalid semantic version: '" + std::string( version ) + "'"
+        );
+      }
+    this->setText( version, parts );
+  }
+
+
+  CompactSemVer::CompactSemVer( const SemVer & semver )
+  {
+    if ( ! ( semver.major.has_value() && semver.minor.has_value() &&
+             semver.patch.has_value()
+           )
+       )
+      {
+        throw std::invalid_argument(
+          "Cannot compact partial version: '" + semver.version + "'"
+        );
+      }
+
+    SemVerParts parts;
+    if ( semver.lazy )
+      {
+        if ( ! scanSemVer( semver.raw, semver.loose, parts ) )
+          {
+            throw std::invalid_argument(
+              "Invalid semantic version: '" + semver.raw + "'"
+            );
+          }
+        this->setText( semver.raw, parts );
+        return;
+      }
+
+    std::string version = semver.version;
+    if ( ! semver.build.empty() )
+      {
+        version += "+" + joinIdentifiers( semver.build );
+      }
+
+    /* The canonical rendering is valid in the loose grammar, unless the
+     * members were modified after parsing. */
+    if ( ! scanSemVer( version, true, parts ) )
+      {
+        throw std::invalid_argument(
+          "Invalid semantic version: '" + version + "'"
+        );
+      }
+    this->setText( version, parts );
+  }
+
+
+  CompactSemVer::CompactSemVer( const CompactSemVer & other )
+    : text()
+    , main { other.main[0], other.main[1], other.main[2] }
+    , textSize( other.textSize )
+    , preBegin( other.preBegin )
+    , preEnd( other.preEnd )
+    , buildBegin( other.buildBegin )
+  {
+    if ( other.text != nullptr )
+      {
+        this->text = std::make_unique<char[]>( this->textSize );
+        std::memcpy( this->text.get(), other.text.get(), this->textSize );
+      }
+  }
+
+
+    CompactSemVer &
+  CompactSemVer::operator=( const CompactSemVer & other )
+  {
+    if ( this != & other )
+      {
+        * this = CompactSemVer( other );
+      }
+    return * this;
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+  /**
+   * Record the parts found by `scanSemVer' in `version', keeping a copy of
+   * `version' only if it has pre-release or build identifiers.
+   */
+    void
+  CompactSemVer::setText( std::string_view version, const SemVerParts & parts )
+  {
+    this->main[0] = parts.major;
+    this->main[1] = parts.minor;
+    this->main[2] = parts.patch;
+
+    if ( parts.prerelease.empty() && parts.build.empty() )
+      {
+        this->text       = nullptr;
+        this->textSize   = 0;
+        this->preBegin   = 0;
+        this->preEnd     = 0;
+        this->buildBegin = 0;
+        return;
+      }
+
+    if ( std::numeric_limits<std::uint16_t>::max() < version.size() )
+      {
+        throw std::invalid_argument(
+          "Version string is too long to compact: '" + std::string( version ) +
+          "'"
+        );
+      }
+
+    this->textSize = version.size();
+    this->text     = std::make_unique<char[]>( version.size() );
+    std::memcpy( this->text.get(), version.data(), version.size() );
+
+    if ( parts.prerelease.empty() )
+      {
+        this->preBegin = 0;
+        this->preEnd   = 0;
+      }
+    else
+      {
+        this->preBegin = parts.prerelease.data() - version.data();
+        this->preEnd   = this->preBegin + parts.prerelease.size();
+      }
+
+    this->buildBegin = parts.build.empty()
+                       ? this->textSize
+                       : ( parts.build.data() - version.data() );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    VersionKey
+  CompactSemVer::key() const
+  {
+    return makeVersionKey( this->main[0], this->main[1], this->main[2]
+                         , this->preBegin != this->preEnd
+                         );
+  }
+
+
+    std::string_view
+  CompactSemVer::prerelease() const
+  {
+    return std::string_view( this->text.get() + this->preBegin
+                           , this->preEnd - this->preBegin
+                           );
+  }
+
+
+    std::string_view
+  CompactSemVer::build() const
+  {
+    return std::string_view( this->text.get() + this->buildBegin
+                           , this->textSize - this->buildBegin
+                           );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    SemVer
+  CompactSemVer::toSemVer() const
+  {
+    SemVer rsl( this->main[0], this->main[1], this->main[2]
+              , splitIdentifiers( this->prerelease() )
+              , splitIdentifiers( this->build() )
+              );
+    if ( this->text != nullptr )
+      {
+        rsl.raw = std::string( this->text.get(), this->textSize );
+      }
+    return rsl;
+  }
+
+
+    std::string
+  CompactSemVer::toString() const
+  {
+    std::string rsl = std::to_string( this->main[0] ) + "." +
+                      std::to_string( this->main[1] ) + "." +
+                      std::to_string( this->main[2] );
+    if ( this->preBegin != this->preEnd )
+      {
+        rsl += "-";
+        rsl += this->prerelease();
+      }
+    return rsl;
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    char
+  CompactSemVer::compare( const CompactSemVer & other ) const
+  {
+    const VersionKey a = this->key();
+    const VersionKey b = other.key();
+    if ( ( a != b ) || ( ( a & 1 ) != 0 ) )
+      {
+        return compareVersionKeys( a, b );
+      }
+    return compareIdentifiers( this->prerelease(), other.prerelease() );
+  }
+
+
+    char
+  CompactSemVer::compareMain( const CompactSemVer & other ) const
+  {
+    return compareVersionKeys( this->key() >> 1, other.key() >> 1 );
+  }
+
+
+    char
+  CompactSemVer::comparePre( const CompactSemVer & other ) const
+  {
+    return compareIdentifierLists( this->prerelease(), other.prerelease() );
+  }
+
+
+    char
+  CompactSemVer::compareBuild( const CompactSemVer & other ) const
+  {
+    return compareIdentifierLists( this->build(), other.build() );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,119 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "semver.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * A space efficient alternative to `SemVer' for holding large numbers of
+ * versions in memory.
+ *
+ * The main version is stored inline.
+ * Versions with pre-release or build identifiers additionally keep a single
+ * copy of their version string, and refer to those identifiers by their
+ * offsets into it; plain releases make no heap allocations at all.
+ * Version strings longer than 65535 characters are rejected.
+ */
+struct CompactSemVer {
+
+/* -------------------------------------------------------------------------- */
+
+  public:
+
+    /* Constructors */
+
+    CompactSemVer( std::string_view version, bool loose = false );
+
+    explicit CompactSemVer( const SemVer & semver );
+
+    CompactSemVer( const CompactSemVer & other );
+    CompactSemVer( CompactSemVer && other ) noexcept = default;
+
+    CompactSemVer & operator=( const CompactSemVer & other );
+    CompactSemVer & operator=( CompactSemVer && other ) noexcept = default;
+
+
+/* -------------------------------------------------------------------------- */
+
+    /* Accessors */
+
+    unsigned int major() const { return this->main[0]; }
+    unsigned int minor() const { return this->main[1]; }
+    unsigned int patch() const { return this->main[2]; }
+
+    VersionKey key() const;
+
+    /** Dot separated pre-release identifiers, or an empty string. */
+    std::string_view prerelease() const;
+
+    /** Dot separated build identifiers, or an empty string. */
+    std::string_view build() const;
+
+
+/* -------------------------------------------------------------------------- */
+
+    /* Serializers */
+
+    SemVer toSemVer() const;
+
+    /** Render the version the way `SemVer::toString' does, omitting build. */
+    std::string toString() const;
+
+
+/* -------------------------------------------------------------------------- */
+
+    /* Comparators */
+
+    char compare(      const CompactSemVer & other ) const;
+    char compareMain(  const CompactSemVer & other ) const;
+    char comparePre(   const CompactSemVer & other ) const;
+    char compareBuild( const CompactSemVer & other ) const;
+
+
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    /* Data Members */
+
+    /** The version string, only kept if it has pre-release or build parts. */
+    std::unique_ptr<char[]> text;
+
+    unsigned int  main[3];
+    std::uint16_t textSize;
+    std::uint16_t preBegin;
+    std::uint16_t preEnd;
+    std::uint16_t buildBegin;
+
+    void setText( std::string_view version, const SemVerParts & parts );
+
+
+/* -------------------------------------------------------------------------- */
+
+};  /* End struct `CompactSemVer' */
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
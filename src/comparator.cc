@@ -4,11 +4,13 @@
  *
  * -------------------------------------------------------------------------- */
 
+#include <algorithm>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
 
 #include "comparator.hh"
+#include "interval.hh"
 #include "regexes.hh"
 #include "semver.hh"
 #include "range.hh"
@@ -21,55 +23,63 @@ namespace semi {
 
   static const SemVer ANY = SemVer();
 
+  /** Whether `semver' is `ANY', or another version without any parts set. */
+    static inline bool
+  isAny( const SemVer & semver )
+  {
+    return ! semver.major.has_value();
+  }
 
-/* -------------------------------------------------------------------------- */
 
-    static bool
-  cmp( const SemVer & a, std::string_view op, const SemVer & b, bool loose )
+  /** The operator `op' is written as most briefly, "" for equality. */
+    static std::string_view
+  canonicalOp( std::string_view op )
   {
-    if ( op == "===" )
+    if ( ( op == "=" ) || ( op == "==" ) || ( op == "===" ) )
       {
-        return a.version == b.version;
+        return "";
       }
     if ( op == "!==" )
       {
-        return a.version != b.version;
+        return "!=";
       }
+    return op;
+  }
 
-    const SemVer _a =
-      a.loose == loose ? a : SemVer( a.version, a.includePrerelease, loose );
-    const SemVer _b =
-      a.loose == loose ? b : SemVer( b.version, b.includePrerelease, loose );
 
-    if ( ( op == "" ) || ( op == "=" ) || ( op == "==" ) )
+/* -------------------------------------------------------------------------- */
+
+  /**
+   * Whether the result `c' of comparing a version to a comparator's version
+   * satisfies the operator `op'.
+   */
+    static bool
+  testOp( std::string_view op, char c )
+  {
+    if ( ( op == "" ) || ( op == "=" ) || ( op == "==" ) || ( op == "===" ) )
       {
-        return _a.compare( _b ) == 0;
+        return c == 0;
       }
-    if ( op == "!=" )
+    if ( ( op == "!=" ) || ( op == "!==" ) )
       {
-        return _a.compare( _b ) != 0;
+        return c != 0;
       }
     if ( op == ">" )
       {
-        return _a.compare( _b ) > 0;
+        return 0 < c;
       }
     if ( op == ">=" )
       {
-        return _a.compare( _b ) >= 0;
+        return 0 <= c;
       }
     if ( op == "<" )
       {
-        return _a.compare( _b ) < 0;
+        return c < 0;
       }
     if ( op == "<=" )
       {
-        return _a.compare( _b ) <= 0;
+        return c <= 0;
       }
-
-    throw std::invalid_argument(
-      "Invalid operator: '" + std::string( op ) + "'"
-    );
-    /* Unreachable */
     return false;
   }
 
@@ -84,7 +94,7 @@ namespace semi {
     this->includePrerelease = includePrerelease;
     this->loose             = loose;
     parseComparator( comp );
-    if ( this->semver.compare( ANY ) == 0 )
+    if ( isAny( this->semver ) )
       {
         this->value = "";
       }
@@ -104,7 +114,11 @@ namespace semi {
     this->semver            = semver;
     this->includePrerelease = includePrerelease;
     this->loose             = loose;
-    if ( this->semver.compare( ANY ) == 0 )
+    if ( this->semver.lazy )
+      {
+        this->semver.format();
+      }
+    if ( isAny( this->semver ) )
       {
         this->value = "";
       }
@@ -120,9 +134,11 @@ namespace semi {
     void
   Comparator::parseComparator( std::string_view comp )
   {
-    const std::regex pattern(
-      this->loose ? re::COMPARATORLOOSE : re::COMPARATOR, std::regex::ECMAScript
-    );
+    static const std::regex strict( re::COMPARATOR, std::regex::ECMAScript );
+    static const std::regex loose( re::COMPARATORLOOSE
+                                 , std::regex::ECMAScript
+                                 );
+    const std::regex & pattern = this->loose ? loose : strict;
     std::string _comp( comp );
     std::smatch match;
     if ( std::regex_match( _comp, match, pattern ) )
@@ -166,85 +182,85 @@ namespace semi {
 
     /* Comparators */
 
+  /**
+   * Comparators intersect if some version satisfies both.
+   * As with ranges, a pre-release only counts if pre-releases are included or
+   * one of the comparators is on a pre-release of the same main version.
+   */
     bool
   Comparator::intersects( const Comparator & other
                         ,       bool         includePrerelease
-                        ,       bool         loose
+                        ,       bool
                         ) const
   {
-    if ( this->op == "" )
+    const IntervalSet both = IntervalSet::compile( { { * this, other } } );
+    if ( both.empty() )
       {
-        if ( this->value == "" )
-          {
-            return true;
-          }
-        const Range r = Range( other.value, includePrerelease, loose );
-        return r.test( this->value );
+        return false;
       }
-    else if ( other.op == "" )
-      {
-        if ( other.value == "" )
-          {
-            return true;
-          }
-        const Range r = Range( this->value, includePrerelease, loose );
-        return r.test( other.semver );
-      }
-
-    const bool sameDirectionIncreasing =
-      ( ( this->op == ">=" ) || ( this->op == ">" ) ) &&
-      ( ( other.op == ">=" ) || ( other.op == ">" ) );
-
-    const bool sameDirectionDecreasing =
-      ( ( this->op == "<=" ) || ( this->op == "<" ) ) &&
-      ( ( other.op == "<=" ) || ( other.op == "<" ) );
-
-    const bool sameSemVer = this->semver.version == other.semver.version;
-
-    const bool differentDirectionsInclusive =
-      ( ( this->op == ">=" ) || ( this->op == "<=" ) ) &&
-      ( ( other.op == ">=" ) || ( other.op == "<=" ) );
-
-    const bool oppositeDirectionsLessThan =
-      cmp( this->semver, "<", other.semver, loose ) &&
-      ( ( this->op == ">=" ) || ( this->op == ">" ) ) &&
-      ( ( other.op == "<=" ) || ( other.op == "<" ) );
-
-    const bool oppositeDirectionsGreaterThan =
-      cmp( this->semver, ">", other.semver, loose ) &&
-      ( ( this->op == "<=" ) || ( this->op == "<" ) ) &&
-      ( ( other.op == ">=" ) || ( other.op == ">" ) );
-
-    return
-      sameDirectionIncreasing || sameDirectionDecreasing ||
-      ( sameSemVer && differentDirectionsInclusive ) ||
-      oppositeDirectionsLessThan || oppositeDirectionsGreaterThan;
+    return includePrerelease || ( ! both.prerelease.empty() ) ||
+           std::any_of( both.intervals.cbegin(), both.intervals.cend()
+                      , []( const Interval & i )
+                        {
+                          return containsRelease( i.lower, i.upper );
+                        }
+                      );
   }
 
 
     bool
   Comparator::test( const SemVer & version ) const
   {
-    if ( ( this->semver.compare( ANY ) == 0 ) ||
-         ( version.compare( ANY ) == 0 )
-       )
+    if ( isAny( this->semver ) || isAny( version ) )
       {
         return true;
       }
+    return testOp( this->op, version.compare( this->semver ) );
+  }
 
-    bool rsl = false;
+    bool
+  Comparator::test( const SemVerView & version ) const
+  {
+    if ( isAny( this->semver ) )
+      {
+        return true;
+      }
+    return testOp( this->op, version.compare( this->semver ) );
+  }
+
+    bool
+  Comparator::operator==( const Comparator & other ) const
+  {
+    if ( isAny( this->semver ) || isAny( other.semver ) )
+      {
+        return isAny( this->semver ) && isAny( other.semver );
+      }
+    return ( canonicalOp( this->op ) == canonicalOp( other.op ) ) &&
+           ( this->semver == other.semver );
+  }
 
-    try { rsl = cmp( this->semver, this->op, version, this->loose ); }
-    catch( ... ) {}
 
-    return rsl;
+    uint64_t
+  Comparator::hash() const
+  {
+    if ( isAny( this->semver ) )
+      {
+        return 0;
+      }
+    return hashCombine( this->semver.hash()
+                      , std::hash<std::string_view>()(
+                          canonicalOp( this->op )
+                        )
+                      );
   }
 
+
     bool
   Comparator::test( std::string_view version ) const
   {
-    const SemVer o = SemVer( version, this->includePrerelease, this->loose );
-    return this->test( o );
+    const std::optional<SemVerView> o =
+      SemVerView::parse( version, this->loose );
+    return o.has_value() && this->test( * o );
   }
 
 
@@ -6,10 +6,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include "semver.hh"
+#include "view.hh"
 
 /* -------------------------------------------------------------------------- */
 
@@ -79,8 +81,19 @@ struct Comparator {
                    ) const;
 
     bool test( const SemVer     & version ) const;
+    bool test( const SemVerView & version ) const;
     bool test( std::string_view   version ) const;
 
+    /**
+     * Whether comparators have the same operator, counting "=" and "==" as
+     * none, on versions equal under `SemVer::operator=='.
+     * Comparators on no version accept anything, so are all equal.
+     */
+    bool operator==( const Comparator & other ) const;
+
+    /** A hash consistent with `operator=='. */
+    uint64_t hash() const;
+
 
 /* -------------------------------------------------------------------------- */
 
@@ -98,6 +111,18 @@ struct Comparator {
 
 }  /* End Namespace `semi' */
 
+
+/* -------------------------------------------------------------------------- */
+
+template <>
+struct std::hash<semi::Comparator> {
+    size_t
+  operator()( const semi::Comparator & comp ) const noexcept
+  {
+    return comp.hash();
+  }
+};
+
 /* -------------------------------------------------------------------------- *
  *
  *
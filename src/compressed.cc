@@ -0,0 +1,398 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+#include "compressed.hh"
+#include "view.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/** Append `value' as a little-endian base 128 varint. */
+  static void
+putVarint( std::vector<uint8_t> & out, VersionKey value )
+{
+  while ( 0x80 <= value )
+    {
+      out.push_back( static_cast<uint8_t>( value ) | 0x80 );
+      value >>= 7;
+    }
+  out.push_back( static_cast<uint8_t>( value ) );
+}
+
+
+  static VersionKey
+getVarint( const uint8_t * & in )
+{
+  VersionKey rsl   = 0;
+  unsigned   shift = 0;
+  while ( ( * in & 0x80 ) != 0 )
+    {
+      rsl   |= static_cast<VersionKey>( * in++ & 0x7f ) << shift;
+      shift += 7;
+    }
+  return rsl | ( static_cast<VersionKey>( * in++ ) << shift );
+}
+
+
+/** Dot separated build identifiers, whether or not `version' is lazy. */
+  static std::string
+buildText( const SemVer & version )
+{
+  if ( version.lazy )
+    {
+      const SemVerView view( version.raw, version.loose );
+      return std::string( view.parts.build );
+    }
+  std::string rsl;
+  for ( const std::string & id : version.build )
+    {
+      if ( ! rsl.empty() )
+        {
+          rsl += '.';
+        }
+      rsl += id;
+    }
+  return rsl;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+CompressedCatalog::CompressedCatalog( const VersionCatalog & catalog )
+{
+  this->encode( std::vector<SemVer>( catalog.versions().begin()
+                                   , catalog.versions().end()
+                                   )
+              );
+}
+
+
+CompressedCatalog::CompressedCatalog( std::vector<SemVer> versions )
+{
+  std::stable_sort( versions.begin(), versions.end(), lessVersion );
+  this->encode( versions );
+}
+
+
+  void
+CompressedCatalog::encode( const std::vector<SemVer> & sorted )
+{
+  std::unordered_map<std::string, uint32_t> ids = { { "", 0 } };
+  auto intern = [&]( std::string s ) -> uint32_t
+    {
+      auto [it, added] = ids.emplace( std::move( s ), this->strings.size() );
+      if ( added )
+        {
+          this->strings.push_back( it->first );
+        }
+      return it->second;
+    };
+
+  this->nVersions = sorted.size();
+  Entry prev {};
+  for ( size_t i = 0; i < sorted.size(); ++i )
+    {
+      const Entry entry {
+        sorted[i].key
+      , intern( std::string( sorted[i].prereleaseText() ) )
+      , intern( buildText( sorted[i] ) )
+      };
+      if ( i % blockSize == 0 )
+        {
+          this->skips.push_back( entry );
+          this->offsets.push_back( this->data.size() );
+          this->releasesBefore.push_back( this->releasesBefore.back() );
+        }
+      else
+        {
+          putVarint( this->data, entry.key - prev.key );
+          putVarint( this->data, entry.tag );
+          putVarint( this->data, entry.build );
+        }
+      /* The last count runs on to the end of the current block. */
+      this->releasesBefore.back() += entry.key & 1;
+      prev = entry;
+    }
+  this->data.shrink_to_fit();
+  this->strings.shrink_to_fit();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  void
+CompressedCatalog::decode( size_t block, Block & out ) const
+{
+  const size_t begin = block * blockSize;
+  out.size           = std::min( blockSize, this->nVersions - begin );
+  out.entries[0]     = this->skips[block];
+  const uint8_t * in = this->data.data() + this->offsets[block];
+  for ( size_t i = 1; i < out.size; ++i )
+    {
+      out.entries[i].key   = out.entries[i - 1].key + getVarint( in );
+      out.entries[i].tag   = static_cast<uint32_t>( getVarint( in ) );
+      out.entries[i].build = static_cast<uint32_t>( getVarint( in ) );
+    }
+}
+
+
+  SemVer
+CompressedCatalog::toSemVer( const Entry & entry ) const
+{
+  return SemVer( static_cast<unsigned int>( entry.key >> 65 )
+               , static_cast<unsigned int>( entry.key >> 33 )
+               , static_cast<unsigned int>( entry.key >> 1 )
+               , splitIdentifiers( this->strings[entry.tag] )
+               , splitIdentifiers( this->strings[entry.build] )
+               );
+}
+
+
+  SemVer
+CompressedCatalog::at( size_t i ) const
+{
+  Block block;
+  this->decode( i / blockSize, block );
+  return this->toSemVer( block.entries[i % blockSize] );
+}
+
+
+  size_t
+CompressedCatalog::bytes() const
+{
+  size_t rsl = this->data.capacity() +
+               this->skips.capacity() * sizeof( Entry ) +
+               this->offsets.capacity() * sizeof( uint32_t ) +
+               this->releasesBefore.capacity() * sizeof( uint32_t ) +
+               this->strings.capacity() * sizeof( std::string );
+  for ( const std::string & s : this->strings )
+    {
+      /* Short strings are stored inline, up to a limit which differs between
+       * standard libraries, so check where the characters are. */
+      const char * const object = reinterpret_cast<const char *>( & s );
+      const std::less<const char *> before;
+      if ( before( s.data(), object ) ||
+           ( ! before( s.data(), object + sizeof( std::string ) ) )
+         )
+        {
+          rsl += s.capacity() + 1;
+        }
+    }
+  return rsl;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  char
+CompressedCatalog::compare( const Entry & entry, const SemVer & version ) const
+{
+  return compareKeyed( entry.key, this->strings[entry.tag]
+                     , version.key, version
+                     );
+}
+
+
+  size_t
+CompressedCatalog::search( const SemVer & bound, bool after ) const
+{
+  auto reached = [&]( const Entry & entry )
+    {
+      const char cmp = this->compare( entry, bound );
+      return after ? ( 0 < cmp ) : ( 0 <= cmp );
+    };
+
+  /* The first block starting at or after `bound', with the answer either in
+   * the block before it or at its start. */
+  const size_t next = std::partition_point( this->skips.cbegin()
+                                          , this->skips.cend()
+                                          , [&]( const Entry & skip )
+                                            {
+                                              return ! reached( skip );
+                                            }
+                                          ) - this->skips.cbegin();
+  if ( next == 0 )
+    {
+      return 0;
+    }
+  Block block;
+  this->decode( next - 1, block );
+  const Entry * found = std::find_if( block.entries + 1
+                                    , block.entries + block.size
+                                    , reached
+                                    );
+  return ( next - 1 ) * blockSize + ( found - block.entries );
+}
+
+
+  size_t
+CompressedCatalog::releasesBeforeIndex( size_t i ) const
+{
+  const size_t b   = i / blockSize;
+  size_t       rsl = this->releasesBefore[b];
+  if ( ( i % blockSize ) != 0 )
+    {
+      Block block;
+      this->decode( b, block );
+      for ( size_t e = 0; e < i % blockSize; ++e )
+        {
+          rsl += block.entries[e].key & 1;
+        }
+    }
+  return rsl;
+}
+
+
+  size_t
+CompressedCatalog::releaseIndex( size_t n ) const
+{
+  const size_t b = std::upper_bound( this->releasesBefore.cbegin()
+                                   , this->releasesBefore.cend()
+                                   , n
+                                   ) - this->releasesBefore.cbegin() - 1;
+  Block block;
+  this->decode( b, block );
+  size_t left = n - this->releasesBefore[b];
+  for ( size_t e = 0; ; ++e )
+    {
+      if ( ( block.entries[e].key & 1 ) != 0 )
+        {
+          if ( left == 0 )
+            {
+              return b * blockSize + e;
+            }
+          --left;
+        }
+    }
+}
+
+
+  size_t
+CompressedCatalog::firstEqual( size_t i ) const
+{
+  return this->search( this->at( i ) );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  std::vector<VersionCatalog::Segment>
+CompressedCatalog::segments( const Range & range, bool includePrerelease ) const
+{
+  return VersionCatalog::segmentsOf( range, includePrerelease, this->size()
+                                   , [this]( const SemVer & bound )
+                                     {
+                                       return this->search( bound );
+                                     }
+                                   );
+}
+
+
+  std::vector<SemVer>
+CompressedCatalog::match( const Range & range, bool includePrerelease ) const
+{
+  std::vector<SemVer> rsl;
+  Block               block;
+  size_t              decoded = SIZE_MAX;
+  for ( const VersionCatalog::Segment & s :
+          this->segments( range, includePrerelease )
+      )
+    {
+      for ( size_t i = s.begin; i < s.end; ++i )
+        {
+          if ( decoded != i / blockSize )
+            {
+              decoded = i / blockSize;
+              this->decode( decoded, block );
+            }
+          const Entry & entry = block.entries[i % blockSize];
+          if ( ( ! s.releasesOnly ) || ( ( entry.key & 1 ) != 0 ) )
+            {
+              rsl.push_back( this->toSemVer( entry ) );
+            }
+        }
+    }
+  return rsl;
+}
+
+
+  std::optional<SemVer>
+CompressedCatalog::latest( const Range & range, bool includePrerelease ) const
+{
+  const std::vector<VersionCatalog::Segment> segments =
+    this->segments( range, includePrerelease );
+  for ( auto s = segments.crbegin(); s != segments.crend(); ++s )
+    {
+      size_t last = s->end - 1;
+      if ( s->releasesOnly )
+        {
+          const size_t n = this->releasesBeforeIndex( s->end );
+          if ( n == this->releasesBeforeIndex( s->begin ) )
+            {
+              continue;
+            }
+          last = this->releaseIndex( n - 1 );
+        }
+      return this->at( this->firstEqual( last ) );
+    }
+  return std::nullopt;
+}
+
+
+  std::optional<SemVer>
+CompressedCatalog::earliest( const Range & range, bool includePrerelease ) const
+{
+  for ( const VersionCatalog::Segment & s :
+          this->segments( range, includePrerelease )
+      )
+    {
+      size_t first = s.begin;
+      if ( s.releasesOnly )
+        {
+          const size_t n = this->releasesBeforeIndex( s.begin );
+          if ( n == this->releasesBeforeIndex( s.end ) )
+            {
+              continue;
+            }
+          first = this->releaseIndex( n );
+        }
+      return this->at( first );
+    }
+  return std::nullopt;
+}
+
+
+  size_t
+CompressedCatalog::count( const Range & range, bool includePrerelease ) const
+{
+  size_t rsl = 0;
+  for ( const VersionCatalog::Segment & s :
+          this->segments( range, includePrerelease )
+      )
+    {
+      rsl += s.releasesOnly ? ( this->releasesBeforeIndex( s.end ) -
+                                this->releasesBeforeIndex( s.begin )
+                              )
+                            : ( s.end - s.begin );
+    }
+  return rsl;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
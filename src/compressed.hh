@@ -0,0 +1,155 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "catalog.hh"
+#include "range.hh"
+#include "semver.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * An immutable, compressed encoding of a sorted version catalog, which range
+ * queries run on directly.
+ *
+ * Versions are stored as their packed `VersionKey', plus indices into a
+ * dictionary holding each distinct pre-release and build string once.
+ * Entries are split into blocks of `blockSize'; the first entry of each block
+ * is kept whole as a skip key, and the rest as varint deltas from the entry
+ * before them.
+ * Searches binary search the skip keys and decode only the block they land
+ * in, and per-block release counts let queries step over pre-releases which
+ * are not allowed without decoding the blocks in between.
+ *
+ * Typical versions take two to four bytes each, against `sizeof( SemVer )'
+ * plus its strings.
+ */
+struct CompressedCatalog {
+
+/* -------------------------------------------------------------------------- */
+
+    static constexpr size_t blockSize = 64;
+
+    CompressedCatalog() = default;
+
+    explicit CompressedCatalog( const VersionCatalog & catalog );
+
+    /** Sort and encode versions in any order. */
+    explicit CompressedCatalog( std::vector<SemVer> versions );
+
+    size_t size()  const { return this->nVersions; }
+    bool   empty() const { return this->nVersions == 0; }
+
+    /** Decode version `i', which must be less than `size()'. */
+    SemVer at( size_t i ) const;
+
+    /** Heap bytes held by the encoding. */
+    size_t bytes() const;
+
+
+/* -------------------------------------------------------------------------- */
+
+    /* Queries, accepting versions as `Range::test' does. */
+
+    /** Decode the versions accepted by `range', in ascending order. */
+      std::vector<SemVer>
+    match( const Range & range, bool includePrerelease = false ) const;
+
+    /** The highest version accepted by `range', as `VersionCatalog' does. */
+      std::optional<SemVer>
+    latest( const Range & range, bool includePrerelease = false ) const;
+
+    /** The lowest version accepted by `range'. */
+      std::optional<SemVer>
+    earliest( const Range & range, bool includePrerelease = false ) const;
+
+    /** The number of versions accepted by `range'. */
+    size_t count( const Range & range, bool includePrerelease = false ) const;
+
+
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    struct Entry {
+      VersionKey key;
+      uint32_t   tag;
+      uint32_t   build;
+    };
+
+    /** A decoded block, of which the first `size' entries are set. */
+    struct Block {
+      Entry  entries[blockSize];
+      size_t size;
+    };
+
+    size_t nVersions = 0;
+
+    /** Deltas of each block's entries after the first. */
+    std::vector<uint8_t> data;
+
+    /** The first entry of each block, and where the rest begin in `data'. */
+    std::vector<Entry>    skips;
+    std::vector<uint32_t> offsets;
+
+    /** The number of releases before each block, with one for the end. */
+    std::vector<uint32_t> releasesBefore = { 0 };
+
+    /** Distinct pre-release and build strings, with "" at index 0. */
+    std::vector<std::string> strings = { "" };
+
+    void encode( const std::vector<SemVer> & sorted );
+
+    void decode( size_t block, Block & out ) const;
+
+    SemVer toSemVer( const Entry & entry ) const;
+
+    /** Order an entry against a version, ignoring build metadata. */
+    char compare( const Entry & entry, const SemVer & version ) const;
+
+    /** The first index at or after `bound', or after it if `after'. */
+    size_t search( const SemVer & bound, bool after = false ) const;
+
+    /** The number of releases before index `i'. */
+    size_t releasesBeforeIndex( size_t i ) const;
+
+    /** The index of the release preceded by `n' other releases. */
+    size_t releaseIndex( size_t n ) const;
+
+    /** The index of the first version equal to the one at `i'. */
+    size_t firstEqual( size_t i ) const;
+
+    std::vector<VersionCatalog::Segment> segments(
+      const Range & range
+    ,       bool    includePrerelease
+    ) const;
+
+
+/* -------------------------------------------------------------------------- */
+
+};  /* End struct `CompressedCatalog' */
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,382 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "comparator.hh"
+#include "range.hh"
+#include "semver.hh"
+#include "view.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * How `FlatSet' and `FlatMap' look up elements of type `T' by their text,
+ * which is parsed into a `Key', hashed as an equal `T' would be, and
+ * compared with elements.
+ * Text which does not parse is never found.
+ */
+template <typename T>
+struct FlatLookup;
+
+/** Versions are looked up by `SemVerView', without allocating. */
+template <>
+struct FlatLookup<SemVer> {
+
+  using Key = SemVerView;
+
+    static std::optional<SemVerView>
+  parse( std::string_view text )
+  {
+    return SemVerView::parse( text );
+  }
+
+  static uint64_t hash( const SemVerView & key ) { return key.hash(); }
+
+    static bool
+  equal( const SemVer & element, const SemVerView & key )
+  {
+    return element.major.has_value() && element.minor.has_value() &&
+           element.patch.has_value() && ( key.compare( element ) == 0 );
+  }
+
+};  /* End struct `FlatLookup<SemVer>' */
+
+
+/** Comparators and ranges are parsed to be looked up, which allocates. */
+template <typename T>
+struct FlatParsedLookup {
+
+  using Key = T;
+
+    static std::optional<T>
+  parse( std::string_view text )
+  {
+    try
+      {
+        return T( text );
+      }
+    catch ( const std::invalid_argument & )
+      {
+        return std::nullopt;
+      }
+  }
+
+  static uint64_t hash( const T & key ) { return key.hash(); }
+
+    static bool
+  equal( const T & element, const T & key )
+  {
+    return element == key;
+  }
+
+};  /* End struct `FlatParsedLookup' */
+
+template <>
+struct FlatLookup<Comparator> : FlatParsedLookup<Comparator> {};
+
+template <>
+struct FlatLookup<Range> : FlatParsedLookup<Range> {};
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * An open addressing hash table of `Entry's keyed by `T', the common part of
+ * `FlatSet' and `FlatMap'.
+ *
+ * Entries are kept in a vector in the order they were added, and the table
+ * only holds their indices, probed linearly and grown to stay at most three
+ * quarters full.
+ * Each entry's hash is kept beside it, so that probing only compares entries
+ * whose hashes match, and growing never rehashes an entry.
+ * Elements are hashed and compared with their own `hash' and `operator=='.
+ * Pointers to entries are invalidated by adding entries, and entries cannot
+ * be removed, only cleared all at once.
+ */
+template <typename T, typename Entry = T>
+struct FlatTable {
+
+/* -------------------------------------------------------------------------- */
+
+    using value_type     = Entry;
+    using iterator       = typename std::vector<Entry>::iterator;
+    using const_iterator = typename std::vector<Entry>::const_iterator;
+
+    size_t size()  const { return this->entries.size(); }
+    bool   empty() const { return this->entries.empty(); }
+
+    /** Entries are iterated in the order they were added. */
+    iterator       begin()       { return this->entries.begin(); }
+    iterator       end()         { return this->entries.end(); }
+    const_iterator begin() const { return this->entries.cbegin(); }
+    const_iterator end()   const { return this->entries.cend(); }
+
+      void
+    clear()
+    {
+      this->entries.clear();
+      this->hashes.clear();
+      this->slots.clear();
+    }
+
+    /** Make room for `n' entries without growing. */
+      void
+    reserve( size_t n )
+    {
+      this->entries.reserve( n );
+      this->hashes.reserve( n );
+      if ( this->slots.size() * 3 < n * 4 )
+        {
+          this->rehash( n );
+        }
+    }
+
+    /** The entry with an element equal to `element', or `nullptr'. */
+      const Entry *
+    find( const T & element ) const
+    {
+      const size_t i = this->search( element.hash(), [&]( const Entry & e )
+        {
+          return keyOf( e ) == element;
+        } );
+      return ( i == npos ) ? nullptr : & this->entries[i];
+    }
+
+    /** The entry with an element equal to the one `text' parses as. */
+      const Entry *
+    find( std::string_view text ) const
+    {
+      using Lookup = FlatLookup<T>;
+      const std::optional<typename Lookup::Key> key = Lookup::parse( text );
+      if ( ! key.has_value() )
+        {
+          return nullptr;
+        }
+      const size_t i = this->search( Lookup::hash( * key )
+                                   , [&]( const Entry & e )
+                                     {
+                                       return Lookup::equal( keyOf( e )
+                                                           , * key
+                                                           );
+                                     }
+                                   );
+      return ( i == npos ) ? nullptr : & this->entries[i];
+    }
+
+      Entry *
+    find( const T & element )
+    {
+      return const_cast<Entry *>( std::as_const( * this ).find( element ) );
+    }
+
+      Entry *
+    find( std::string_view text )
+    {
+      return const_cast<Entry *>( std::as_const( * this ).find( text ) );
+    }
+
+      bool
+    contains( const T & element ) const
+    {
+      return this->find( element ) != nullptr;
+    }
+
+      bool
+    contains( std::string_view text ) const
+    {
+      return this->find( text ) != nullptr;
+    }
+
+
+/* -------------------------------------------------------------------------- */
+
+  protected:
+
+    static constexpr size_t npos = SIZE_MAX;
+
+    std::vector<Entry>    entries;
+    std::vector<uint64_t> hashes;
+
+    /** Indices of entries plus one, or zero for empty slots. */
+    std::vector<size_t> slots;
+
+    static const T & keyOf( const T & entry ) { return entry; }
+
+      template <typename V>
+      static const T &
+    keyOf( const std::pair<T, V> & entry )
+    {
+      return entry.first;
+    }
+
+    /**
+     * Add the entry made by `make()' unless `element' is already present,
+     * returning the entry with that element and whether it was added.
+     * Nothing is made, or copied, if the element is present.
+     */
+      template <typename Make>
+      std::pair<Entry *, bool>
+    emplace( const T & element, Make make )
+    {
+      const uint64_t hash  = element.hash();
+      const size_t   found = this->search( hash, [&]( const Entry & e )
+        {
+          return keyOf( e ) == element;
+        } );
+      if ( found != npos )
+        {
+          return { & this->entries[found], false };
+        }
+      if ( this->slots.size() * 3 < ( this->size() + 1 ) * 4 )
+        {
+          this->rehash( std::max<size_t>( 8, this->size() * 2 ) );
+        }
+      this->entries.push_back( make() );
+      this->hashes.push_back( hash );
+      this->place( this->size() - 1 );
+      return { & this->entries.back(), true };
+    }
+
+
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    /** The index of the entry with `hash' satisfying `equal', or `npos'. */
+      template <typename Equal>
+      size_t
+    search( uint64_t hash, Equal equal ) const
+    {
+      if ( this->slots.empty() )
+        {
+          return npos;
+        }
+      const size_t mask = this->slots.size() - 1;
+      for ( size_t s = hash & mask; this->slots[s] != 0; s = ( s + 1 ) & mask )
+        {
+          const size_t i = this->slots[s] - 1;
+          if ( ( this->hashes[i] == hash ) && equal( this->entries[i] ) )
+            {
+              return i;
+            }
+        }
+      return npos;
+    }
+
+    /** Put entry `i' in the first free slot from its hash. */
+      void
+    place( size_t i )
+    {
+      const size_t mask = this->slots.size() - 1;
+      size_t       s    = this->hashes[i] & mask;
+      while ( this->slots[s] != 0 )
+        {
+          s = ( s + 1 ) & mask;
+        }
+      this->slots[s] = i + 1;
+    }
+
+    /** Resize the table to hold `n' entries at most three quarters full. */
+      void
+    rehash( size_t n )
+    {
+      size_t capacity = 8;
+      while ( capacity * 3 < n * 4 )
+        {
+          capacity *= 2;
+        }
+      this->slots.assign( capacity, 0 );
+      for ( size_t i = 0; i < this->size(); ++i )
+        {
+          this->place( i );
+        }
+    }
+
+
+/* -------------------------------------------------------------------------- */
+
+};  /* End struct `FlatTable' */
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * A set of versions, comparators, or ranges, for deduplicating them without
+ * rendering them to strings.
+ */
+template <typename T>
+struct FlatSet : FlatTable<T> {
+
+  /**
+   * Add `element' unless an equal one is present, returning the element kept
+   * and whether it was added.
+   */
+    std::pair<const T *, bool>
+  insert( const T & element )
+  {
+    return this->emplace( element, [&]() { return element; } );
+  }
+
+    std::pair<const T *, bool>
+  insert( T && element )
+  {
+    return this->emplace( element, [&]() { return std::move( element ); } );
+  }
+
+};  /* End struct `FlatSet' */
+
+
+/** A map from versions, comparators, or ranges to `V'. */
+template <typename K, typename V>
+struct FlatMap : FlatTable<K, std::pair<K, V>> {
+
+  /**
+   * Add `value' under `key' unless an equal key is present, returning the
+   * entry kept and whether it was added.
+   * Keys must not be modified through the returned entry.
+   */
+    std::pair<std::pair<K, V> *, bool>
+  try_emplace( const K & key, V value = V() )
+  {
+    return this->emplace( key, [&]()
+      {
+        return std::pair<K, V>( key, std::move( value ) );
+      } );
+  }
+
+  /** The value under `key', adding a default one if there is none. */
+    V &
+  operator[]( const K & key )
+  {
+    return this->try_emplace( key ).first->second;
+  }
+
+};  /* End struct `FlatMap' */
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,255 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "catalog.hh"
+#include "intern.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+    std::shared_ptr<const IntervalSet>
+  RangeInterner::intern( const Range & range )
+  {
+    return this->intern( range.canonical() );
+  }
+
+
+    std::shared_ptr<const IntervalSet>
+  RangeInterner::intern( IntervalSet canonical )
+  {
+    const uint64_t hash         = canonical.hash();
+    const auto     [begin, end]  = this->sets.equal_range( hash );
+    for ( auto i = begin; i != end; ++i )
+      {
+        if ( * i->second == canonical )
+          {
+            return i->second;
+          }
+      }
+    auto shared =
+      std::make_shared<const IntervalSet>( std::move( canonical ) );
+    this->sets.emplace( hash, shared );
+    return shared;
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    size_t
+  RangeInterner::collect()
+  {
+    size_t dropped = 0;
+    for ( auto i = this->sets.begin(); i != this->sets.end(); )
+      {
+        if ( i->second.use_count() == 1 )
+          {
+            i = this->sets.erase( i );
+            ++dropped;
+          }
+        else
+          {
+            ++i;
+          }
+      }
+    return dropped;
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    VersionPool::Id
+  VersionPool::intern( const SemVer & version )
+  {
+    if ( this->size() == UINT32_MAX )
+      {
+        throw std::length_error( "Too many versions to intern" );
+      }
+    const SemVer * kept = this->versions.insert( version ).first;
+    return kept - & * this->versions.begin();
+  }
+
+
+    VersionPool::Id
+  VersionPool::intern( std::string_view version )
+  {
+    const std::optional<Id> found = this->find( version );
+    return found.has_value() ? * found : this->intern( SemVer( version ) );
+  }
+
+
+    std::optional<VersionPool::Id>
+  VersionPool::find( const SemVer & version ) const
+  {
+    const SemVer * found = this->versions.find( version );
+    if ( found == nullptr )
+      {
+        return std::nullopt;
+      }
+    return found - & * this->versions.begin();
+  }
+
+
+    std::optional<VersionPool::Id>
+  VersionPool::find( std::string_view version ) const
+  {
+    const SemVer * found = this->versions.find( version );
+    if ( found == nullptr )
+      {
+        return std::nullopt;
+      }
+    return found - & * this->versions.begin();
+  }
+
+
+    const SemVer &
+  VersionPool::operator[]( Id id ) const
+  {
+    return * ( this->versions.begin() + id );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    void
+  VersionPool::rerank()
+  {
+    if ( this->ranked == this->size() )
+      {
+        return;
+      }
+    auto less = [this]( Id a, Id b )
+      {
+        return ( * this )[a].compare( ( * this )[b] ) < 0;
+      };
+
+    /* Sort the new ids, and merge them into the ranked ones. */
+    const size_t middle = this->order.size();
+    for ( size_t id = this->ranked; id < this->size(); ++id )
+      {
+        this->order.push_back( id );
+      }
+    std::sort( this->order.begin() + middle, this->order.end(), less );
+    std::inplace_merge( this->order.begin(), this->order.begin() + middle
+                      , this->order.end(), less
+                      );
+
+    this->ranks.resize( this->size() );
+    this->releases.resize( this->size() );
+    for ( size_t r = 0; r < this->order.size(); ++r )
+      {
+        this->ranks[this->order[r]] = r;
+        this->releases[r] = ( ( * this )[this->order[r]].key & 1 ) != 0;
+      }
+    this->ranked = this->size();
+    ++this->generations;
+  }
+
+
+    VersionPool::Rank
+  VersionPool::rank( Id id )
+  {
+    this->rerank();
+    return this->ranks[id];
+  }
+
+
+    VersionPool::Id
+  VersionPool::byRank( Rank rank )
+  {
+    this->rerank();
+    return this->order[rank];
+  }
+
+
+    VersionPool::Rank
+  VersionPool::search( const SemVer & bound ) const
+  {
+    return std::lower_bound( this->order.cbegin(), this->order.cend(), bound
+                           , [this]( Id id, const SemVer & b )
+                             {
+                               return ( * this )[id].compare( b ) < 0;
+                             }
+                           ) - this->order.cbegin();
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    VersionPool::RankSet
+  VersionPool::compile( const Range & range, bool includePrerelease )
+  {
+    this->rerank();
+    RankSet rsl { this, {} };
+    for ( const VersionCatalog::Segment & s :
+            VersionCatalog::segmentsOf( range, includePrerelease, this->size()
+                                      , [this]( const SemVer & bound )
+                                        {
+                                          return this->search( bound );
+                                        }
+                                      )
+        )
+      {
+        rsl.runs.push_back( RankSet::Run {
+          static_cast<Rank>( s.begin ), static_cast<Rank>( s.end )
+        , s.releasesOnly
+        } );
+      }
+    return rsl;
+  }
+
+
+    VersionPool::RankSet
+  VersionPool::compile( const Comparator & comp )
+  {
+    this->rerank();
+    RankSet rsl { this, {} };
+    for ( const Interval & i : intervalsOf( comp ) )
+      {
+        const Rank begin = this->search( i.lower );
+        const Rank end   = i.upper.has_value() ? this->search( * i.upper )
+                                               : this->size();
+        if ( begin < end )
+          {
+            rsl.runs.push_back( RankSet::Run { begin, end, false } );
+          }
+      }
+    return rsl;
+  }
+
+
+    bool
+  VersionPool::RankSet::test( Rank rank ) const
+  {
+    /* The last run starting at or before `rank'. */
+    auto run = std::upper_bound( this->runs.cbegin(), this->runs.cend(), rank
+                               , []( Rank r, const Run & run )
+                                 {
+                                   return r < run.begin;
+                                 }
+                               );
+    if ( run == this->runs.cbegin() )
+      {
+        return false;
+      }
+    --run;
+    return ( rank < run->end ) &&
+           ( ( ! run->releasesOnly ) || this->pool->releases[rank] );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,201 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "comparator.hh"
+#include "flat.hh"
+#include "interval.hh"
+#include "range.hh"
+#include "semver.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Hash-conses ranges by their canonical form, so that all equivalent ranges
+ * share a single immutable compiled set.
+ * The shared sets can be tested directly with `IntervalSet::test', with
+ * `includePrerelease' unset, in place of the ranges they came from.
+ *
+ * Interning is not synchronized; a table should be confined to one thread.
+ */
+struct RangeInterner {
+
+/* -------------------------------------------------------------------------- */
+
+    /** The shared set for the canonical form of `range'. */
+      std::shared_ptr<const IntervalSet>
+    intern( const Range & range );
+
+    /**
+     * The shared set equal to `canonical', which must already be in canonical
+     * form, as returned by `IntervalSet::canonical'.
+     */
+      std::shared_ptr<const IntervalSet>
+    intern( IntervalSet canonical );
+
+    /** The number of distinct sets in the table. */
+    size_t size() const { return this->sets.size(); }
+
+    /**
+     * Drop sets which are no longer referenced outside of the table,
+     * returning how many were dropped.
+     */
+    size_t collect();
+
+
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    /** Sets keyed by their hash, with colliding sets sharing a key. */
+    std::unordered_multimap<uint64_t, std::shared_ptr<const IntervalSet>> sets;
+
+
+/* -------------------------------------------------------------------------- */
+
+};  /* End struct `RangeInterner' */
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Interns versions, giving each distinct version a stable `Id' in the order
+ * it was added and a dense `Rank' in `SemVer::compare' order, so that sets of
+ * versions can hold 4 byte ids and ranges can be tested with integer
+ * comparisons of ranks.
+ *
+ * Versions are distinct as `SemVer::operator==' tells, ignoring build
+ * metadata, and the first one added is kept.
+ * Ranks are assigned lazily: versions added since ranks were last asked for
+ * are sorted as a batch and merged with the ranked ones, in O( n + m log m )
+ * time for m new versions.
+ * Re-ranking invalidates any ranks and `RankSet's handed out before it,
+ * which `generation' counts; ids are never invalidated.
+ *
+ * Interning is not synchronized, nor is ranking; a pool should be confined to
+ * one thread.
+ */
+struct VersionPool {
+
+/* -------------------------------------------------------------------------- */
+
+    using Id   = uint32_t;
+    using Rank = uint32_t;
+
+    /**
+     * The ranks of the versions accepted by a range or comparator, as runs
+     * of ranks of which either all or only releases are accepted.
+     */
+    struct RankSet {
+
+      struct Run {
+        Rank begin;
+        Rank end;
+        bool releasesOnly;
+      };
+
+      const VersionPool * pool;
+      std::vector<Run>    runs;
+
+      /** Whether the version of rank `rank' is accepted. */
+      bool test( Rank rank ) const;
+
+    };  /* End struct `RankSet' */
+
+
+/* -------------------------------------------------------------------------- */
+
+    /** The id of `version', adding it if it is new. */
+    Id intern( const SemVer & version );
+
+    /**
+     * The id of the version `version' parses as, adding it if it is new.
+     * Only new versions are constructed; throws `std::invalid_argument' if
+     * `version' is not a valid version.
+     */
+    Id intern( std::string_view version );
+
+    /** The id of `version', or `std::nullopt' if it has not been added. */
+    std::optional<Id> find( const SemVer     & version ) const;
+    std::optional<Id> find( std::string_view   version ) const;
+
+    size_t size() const { return this->versions.size(); }
+
+    /** The version with id `id'. */
+    const SemVer & operator[]( Id id ) const;
+
+    /** The rank of the version with id `id', re-ranking if needed. */
+    Rank rank( Id id );
+
+    /** The id of the version of rank `rank', re-ranking if needed. */
+    Id byRank( Rank rank );
+
+    /** How many times versions have been re-ranked. */
+    size_t generation() const { return this->generations; }
+
+
+/* -------------------------------------------------------------------------- */
+
+    /* Compile ranges into ranks, re-ranking if needed. */
+
+    /** The ranks accepted by `range', as `Range::test' accepts versions. */
+    RankSet compile( const Range & range, bool includePrerelease = false );
+
+    /** The ranks accepted by `comp', as `Comparator::test' accepts versions. */
+    RankSet compile( const Comparator & comp );
+
+
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    /** Versions in id order. */
+    FlatSet<SemVer> versions;
+
+    /**
+     * The rank of each id, the id of each rank, and which ranks are releases,
+     * covering the first `ranked' ids.
+     */
+    std::vector<Rank> ranks;
+    std::vector<Id>   order;
+    std::vector<bool> releases;
+    size_t            ranked      = 0;
+    size_t            generations = 0;
+
+    /** Rank any versions added since the last time. */
+    void rerank();
+
+    /** The first rank at or after `bound'. */
+    Rank search( const SemVer & bound ) const;
+
+
+/* -------------------------------------------------------------------------- */
+
+};  /* End struct `VersionPool' */
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
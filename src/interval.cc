@@ -0,0 +1,880 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <climits>
+#include <queue>
+#include <stdexcept>
+
+#include "comparator.hh"
+#include "interval.hh"
+#include "scan.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+    bool
+  Interval::contains( const SemVer & version ) const
+  {
+    return ( 0 <= version.compare( this->lower ) ) &&
+           ( ( ! this->upper.has_value() ) ||
+             ( version.compare( * this->upper ) < 0 )
+           );
+  }
+
+
+    bool
+  Interval::contains( const SemVerView & version ) const
+  {
+    return ( 0 <= version.compare( this->lower ) ) &&
+           ( ( ! this->upper.has_value() ) ||
+             ( version.compare( * this->upper ) < 0 )
+           );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    const SemVer &
+  minVersion()
+  {
+    static const SemVer min( 0, 0, 0, std::vector<std::string> { "0" } );
+    return min;
+  }
+
+
+  /**
+   * Copy the parts of `version' which are relevant to ordering, dropping build
+   * metadata and any options.
+   */
+    static SemVer
+  boundOf( const SemVer & version )
+  {
+    return SemVer( version.major.value_or( 0 )
+                 , version.minor.value_or( 0 )
+                 , version.patch.value_or( 0 )
+                 , splitIdentifiers( version.prereleaseText() )
+                 );
+  }
+
+
+    std::optional<SemVer>
+  successor( const SemVer & version )
+  {
+    const std::string_view pre = version.prereleaseText();
+    if ( ! pre.empty() )
+      {
+        std::vector<std::string> ids = splitIdentifiers( pre );
+        ids.emplace_back( "0" );
+        return SemVer( version.major.value_or( 0 )
+                     , version.minor.value_or( 0 )
+                     , version.patch.value_or( 0 )
+                     , std::move( ids )
+                     );
+      }
+
+    unsigned int major = version.major.value_or( 0 );
+    unsigned int minor = version.minor.value_or( 0 );
+    unsigned int patch = version.patch.value_or( 0 );
+    if ( patch < UINT_MAX )
+      {
+        ++patch;
+      }
+    else if ( minor < UINT_MAX )
+      {
+        ++minor;
+        patch = 0;
+      }
+    else if ( major < UINT_MAX )
+      {
+        ++major;
+        minor = 0;
+        patch = 0;
+      }
+    else
+      {
+        return std::nullopt;
+      }
+    return SemVer( major, minor, patch, { "0" } );
+  }
+
+
+    Interval
+  prereleasesOf( const SemVer & version )
+  {
+    const unsigned int major = version.major.value_or( 0 );
+    const unsigned int minor = version.minor.value_or( 0 );
+    const unsigned int patch = version.patch.value_or( 0 );
+    return Interval { SemVer( major, minor, patch, { "0" } )
+                    , SemVer( major, minor, patch )
+                    };
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+  /** Compare upper bounds, where an unset bound is greater than any other. */
+    static char
+  compareUpper( const std::optional<SemVer> & a
+              , const std::optional<SemVer> & b
+              )
+  {
+    if ( ! ( a.has_value() && b.has_value() ) )
+      {
+        return ( a.has_value() == b.has_value() ) ? 0
+                                                  : ( a.has_value() ? -1 : 1 );
+      }
+    return a->compare( * b );
+  }
+
+
+    static inline bool
+  isEmpty( const Interval & interval )
+  {
+    return interval.upper.has_value() &&
+           ( 0 <= interval.lower.compare( * interval.upper ) );
+  }
+
+
+    std::vector<Interval>
+  unite( std::vector<Interval> intervals )
+  {
+    intervals.erase( std::remove_if( intervals.begin(), intervals.end()
+                                   , isEmpty
+                                   )
+                   , intervals.end()
+                   );
+    std::sort( intervals.begin(), intervals.end()
+             , []( const Interval & a, const Interval & b )
+               {
+                 return a.lower.compare( b.lower ) < 0;
+               }
+             );
+
+    std::vector<Interval> rsl;
+    for ( Interval & interval : intervals )
+      {
+        if ( ( ! rsl.empty() ) &&
+             ( ( ! rsl.back().upper.has_value() ) ||
+               ( interval.lower.compare( * rsl.back().upper ) <= 0 )
+             )
+           )
+          {
+            if ( compareUpper( rsl.back().upper, interval.upper ) < 0 )
+              {
+                rsl.back().upper = std::move( interval.upper );
+              }
+          }
+        else
+          {
+            rsl.emplace_back( std::move( interval ) );
+          }
+      }
+    return rsl;
+  }
+
+
+    std::vector<Interval>
+  intersect( const std::vector<Interval> & a, const std::vector<Interval> & b )
+  {
+    std::vector<Interval> rsl;
+    auto i = a.cbegin();
+    auto j = b.cbegin();
+    while ( ( i != a.cend() ) && ( j != b.cend() ) )
+      {
+        const char             c     = compareUpper( i->upper, j->upper );
+        const SemVer         & lower = ( i->lower.compare( j->lower ) < 0 )
+                                       ? j->lower
+                                       : i->lower;
+        const std::optional<SemVer> & upper = ( c < 0 ) ? i->upper : j->upper;
+
+        if ( ( ! upper.has_value() ) || ( lower.compare( * upper ) < 0 ) )
+          {
+            rsl.push_back( Interval { lower, upper } );
+          }
+
+        /* Advance whichever interval ends first. */
+        if ( c < 0 )
+          {
+            ++i;
+          }
+        else
+          {
+            ++j;
+          }
+      }
+    return rsl;
+  }
+
+
+  /** A position in a list of intervals: one of the bounds of an interval. */
+  struct IntervalCursor {
+    const std::vector<Interval> * list;
+    size_t                        index;
+    bool                          upper;
+
+      const SemVer &
+    bound() const
+    {
+      const Interval & i = ( * this->list )[this->index];
+      return this->upper ? * i.upper : i.lower;
+    }
+  };
+
+
+    std::vector<Interval>
+  intersect( const std::vector<const std::vector<Interval> *> & lists )
+  {
+    if ( lists.empty() )
+      {
+        return { Interval { minVersion(), std::nullopt } };
+      }
+
+    using Cursor = IntervalCursor;
+    const auto later = []( const Cursor & a, const Cursor & b )
+                       {
+                         return 0 < a.bound().compare( b.bound() );
+                       };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype( later )>
+      heap( later );
+    for ( const std::vector<Interval> * list : lists )
+      {
+        if ( list->empty() )
+          {
+            return {};
+          }
+        heap.push( Cursor { list, 0, false } );
+      }
+
+    /* Count the lists whose intervals contain the sweep's position, and
+     * emit intervals where all of them do. */
+    std::vector<Interval> rsl;
+    size_t                active    = 0;
+    bool                  exhausted = false;
+    const SemVer        * start     = nullptr;
+    while ( ( ! heap.empty() ) && ( ! exhausted ) )
+      {
+        const SemVer * position = & heap.top().bound();
+        while ( ( ! heap.empty() ) &&
+                ( heap.top().bound().compare( * position ) == 0 )
+              )
+          {
+            Cursor c = heap.top();
+            heap.pop();
+            if ( c.upper )
+              {
+                --active;
+                c.upper = false;
+                if ( ++c.index < c.list->size() )
+                  {
+                    heap.push( c );
+                  }
+                else
+                  {
+                    /* Nothing past the end of a list is in all of them. */
+                    exhausted = true;
+                  }
+              }
+            else
+              {
+                ++active;
+                if ( ( * c.list )[c.index].upper.has_value() )
+                  {
+                    c.upper = true;
+                    heap.push( c );
+                  }
+              }
+          }
+
+        if ( ( active == lists.size() ) && ( start == nullptr ) )
+          {
+            start = position;
+          }
+        else if ( ( active < lists.size() ) && ( start != nullptr ) )
+          {
+            rsl.push_back( Interval { * start, * position } );
+            start = nullptr;
+          }
+      }
+    if ( start != nullptr )
+      {
+        rsl.push_back( Interval { * start, std::nullopt } );
+      }
+    return rsl;
+  }
+
+
+    bool
+  containsRelease( const SemVer & lower, const std::optional<SemVer> & upper )
+  {
+    /* The least release at or above `lower' is the release of its main
+     * version, whose key is `lower's with the release bit set. */
+    return ( ! upper.has_value() ) ||
+           ( compareVersionKeys( lower.key | 1, upper->key ) < 0 );
+  }
+
+
+    bool
+  overlaps( const std::vector<Interval> & a
+          , const std::vector<Interval> & b
+          ,       bool                    releases
+          )
+  {
+    auto i = a.cbegin();
+    auto j = b.cbegin();
+    while ( ( i != a.cend() ) && ( j != b.cend() ) )
+      {
+        const char                    c     = compareUpper( i->upper
+                                                          , j->upper
+                                                          );
+        const SemVer                & lower = ( i->lower.compare( j->lower )
+                                                < 0 )
+                                              ? j->lower
+                                              : i->lower;
+        const std::optional<SemVer> & upper = ( c < 0 ) ? i->upper : j->upper;
+
+        if ( releases ? containsRelease( lower, upper )
+                      : ( ( ! upper.has_value() ) ||
+                          ( lower.compare( * upper ) < 0 )
+                        )
+           )
+          {
+            return true;
+          }
+
+        if ( c < 0 )
+          {
+            ++i;
+          }
+        else
+          {
+            ++j;
+          }
+      }
+    return false;
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+  /**
+   * Compare the least version at or above `x' which is of interest to `y'.
+   * For `covers' that is `x' itself.
+   */
+    static inline char
+  compareNextVersion( const SemVer & x, const SemVer & y )
+  {
+    return x.compare( y );
+  }
+
+
+  /**
+   * Compare the least release at or above `x' to `y'.
+   * That is the release of `x's main version, whose key is `x's with the
+   * release bit set.
+   */
+    static inline char
+  compareNextRelease( const SemVer & x, const SemVer & y )
+  {
+    return compareVersionKeys( x.key | 1, y.key );
+  }
+
+
+  /**
+   * Compare the least pre-release at or above `x' to `y'.
+   * For a release that is the "-0" pre-release of the next main version.
+   * Incrementing the packed main version carries in the same way
+   * `successor' does.
+   */
+    static char
+  compareNextPrerelease( const SemVer & x, const SemVer & y )
+  {
+    if ( ( x.key & 1 ) == 0 )
+      {
+        return x.compare( y );
+      }
+    const VersionKey main = x.key >> 1;
+    if ( ( ( main + 1 ) >> 96 ) != 0 )
+      {
+        /* There is no version above the highest release. */
+        return 1;
+      }
+    const char c = compareVersionKeys( main + 1, y.key >> 1 );
+    if ( c != 0 )
+      {
+        return c;
+      }
+    if ( ( y.key & 1 ) != 0 )
+      {
+        return -1;
+      }
+    return ( y.prereleaseText() == "0" ) ? 0 : -1;
+  }
+
+
+  /**
+   * Whether `outer' contains every version of interest in `inner', where
+   * `compareNext( x, y )' compares the least version of interest at or above
+   * `x' to `y'.
+   * Gaps in `outer' are allowed where they contain nothing of interest.
+   */
+template <typename CompareNext>
+    static bool
+  coversWith( const std::vector<Interval> & outer
+            , const std::vector<Interval> & inner
+            ,       CompareNext             compareNext
+            )
+  {
+    auto j = outer.cbegin();
+    for ( const Interval & s : inner )
+      {
+        if ( s.upper.has_value() && ( 0 <= compareNext( s.lower, * s.upper ) ) )
+          {
+            continue;
+          }
+
+        /* Skip to the interval which should contain the start of `s'. */
+        while ( ( j != outer.cend() ) && j->upper.has_value() &&
+                ( 0 <= compareNext( s.lower, * j->upper ) )
+              )
+          {
+            ++j;
+          }
+        if ( ( j == outer.cend() ) || ( compareNext( s.lower, j->lower ) < 0 ) )
+          {
+            return false;
+          }
+
+        /* Extend over intervals until reaching the end of `s'. */
+        while ( j->upper.has_value() &&
+                ( ( ! s.upper.has_value() ) ||
+                  ( compareNext( * j->upper, * s.upper ) < 0 )
+                )
+              )
+          {
+            auto next = j + 1;
+            if ( ( next == outer.cend() ) ||
+                 ( compareNext( * j->upper, next->lower ) < 0 )
+               )
+              {
+                return false;
+              }
+            j = next;
+          }
+      }
+    return true;
+  }
+
+
+    bool
+  covers( const std::vector<Interval> & outer
+        , const std::vector<Interval> & inner
+        )
+  {
+    return coversWith( outer, inner, compareNextVersion );
+  }
+
+
+    bool
+  coversReleases( const std::vector<Interval> & outer
+                , const std::vector<Interval> & inner
+                )
+  {
+    return coversWith( outer, inner, compareNextRelease );
+  }
+
+
+    bool
+  coversPrereleases( const std::vector<Interval> & outer
+                   , const std::vector<Interval> & inner
+                   )
+  {
+    return coversWith( outer, inner, compareNextPrerelease );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    std::vector<Interval>
+  intervalsOf( const Comparator & comp )
+  {
+    if ( ! comp.semver.major.has_value() )
+      {
+        return { Interval { minVersion(), std::nullopt } };
+      }
+
+    const std::string & op = comp.op;
+    const SemVer        v  = boundOf( comp.semver );
+
+    if ( op == ">=" )
+      {
+        return { Interval { v, std::nullopt } };
+      }
+    if ( op == "<" )
+      {
+        return { Interval { minVersion(), v } };
+      }
+    if ( op == ">" )
+      {
+        std::optional<SemVer> s = successor( v );
+        if ( ! s.has_value() )
+          {
+            return {};
+          }
+        return { Interval { std::move( * s ), std::nullopt } };
+      }
+    if ( op == "<=" )
+      {
+        return { Interval { minVersion(), successor( v ) } };
+      }
+    if ( ( op == "" ) || ( op == "=" ) || ( op == "==" ) || ( op == "===" ) )
+      {
+        return { Interval { v, successor( v ) } };
+      }
+    if ( ( op == "!=" ) || ( op == "!==" ) )
+      {
+        std::vector<Interval> rsl = { Interval { minVersion(), v } };
+        std::optional<SemVer> s   = successor( v );
+        if ( s.has_value() )
+          {
+            rsl.push_back( Interval { std::move( * s ), std::nullopt } );
+          }
+        return rsl;
+      }
+
+    throw std::invalid_argument( "Invalid operator: '" + op + "'" );
+  }
+
+
+    IntervalSet
+  IntervalSet::compile( const std::vector<std::vector<Comparator>> & set )
+  {
+    std::vector<Interval> all;
+    std::vector<Interval> allowed;
+
+    for ( const std::vector<Comparator> & comps : set )
+      {
+        std::vector<Interval> intervals = {
+          Interval { minVersion(), std::nullopt }
+        };
+        for ( const Comparator & comp : comps )
+          {
+            intervals = intersect( intervals, intervalsOf( comp ) );
+            if ( intervals.empty() )
+              {
+                break;
+              }
+          }
+        if ( intervals.empty() )
+          {
+            continue;
+          }
+
+        /**
+         * A comparator on a pre-release admits the other pre-releases of its
+         * main version, but only where they satisfy the whole set.
+         */
+        for ( const Comparator & comp : comps )
+          {
+            if ( comp.semver.major.has_value() &&
+                 ( ! comp.semver.prereleaseText().empty() )
+               )
+              {
+                const std::vector<Interval> zone =
+                  intersect( intervals, { prereleasesOf( comp.semver ) } );
+                allowed.insert( allowed.end(), zone.begin(), zone.end() );
+              }
+          }
+
+        all.insert( all.end()
+                  , std::make_move_iterator( intervals.begin() )
+                  , std::make_move_iterator( intervals.end() )
+                  );
+      }
+
+    IntervalSet rsl;
+    rsl.intervals  = unite( std::move( all ) );
+    rsl.prerelease = unite( std::move( allowed ) );
+    return rsl;
+  }
+
+
+  /**
+   * The release immediately before a "-0" pre-release, such as "1.2.3" for
+   * "1.2.4-0" and "1.2.4294967295" for "1.3.0-0".
+   */
+    static SemVer
+  releaseBefore( const SemVer & version )
+  {
+    unsigned int major = version.major.value_or( 0 );
+    unsigned int minor = version.minor.value_or( 0 );
+    unsigned int patch = version.patch.value_or( 0 );
+    if ( 0 < patch )
+      {
+        --patch;
+      }
+    else if ( 0 < minor )
+      {
+        --minor;
+        patch = UINT_MAX;
+      }
+    else
+      {
+        --major;
+        minor = UINT_MAX;
+        patch = UINT_MAX;
+      }
+    return SemVer( major, minor, patch );
+  }
+
+
+  /**
+   * Only the pre-releases of sorted, disjoint intervals, in a unique form:
+   * intervals split by a single release are joined, and releases at the ends
+   * of an interval are dropped.
+   */
+    static std::vector<Interval>
+  prereleasesIn( const std::vector<Interval> & intervals )
+  {
+    std::vector<Interval> joined;
+    for ( const Interval & interval : intervals )
+      {
+        if ( ( ! joined.empty() ) && ( ( joined.back().upper->key & 1 ) != 0 ) )
+          {
+            const std::optional<SemVer> next =
+              successor( * joined.back().upper );
+            if ( next.has_value() && ( next->compare( interval.lower ) == 0 ) )
+              {
+                joined.back().upper = interval.upper;
+                continue;
+              }
+          }
+        joined.push_back( interval );
+      }
+
+    std::vector<Interval> rsl;
+    for ( Interval & interval : joined )
+      {
+        if ( ( interval.lower.key & 1 ) != 0 )
+          {
+            std::optional<SemVer> next = successor( interval.lower );
+            if ( ! next.has_value() )
+              {
+                continue;
+              }
+            interval.lower = std::move( * next );
+          }
+        if ( interval.upper.has_value() &&
+             ( interval.upper->prereleaseText() == "0" ) &&
+             ( interval.upper->compare( minVersion() ) != 0 )
+           )
+          {
+            interval.upper = releaseBefore( * interval.upper );
+          }
+        if ( ! isEmpty( interval ) )
+          {
+            rsl.emplace_back( std::move( interval ) );
+          }
+      }
+    return rsl;
+  }
+
+
+    IntervalSet
+  IntervalSet::canonical( bool includePrerelease ) const
+  {
+    const std::vector<Interval> & pre = includePrerelease ? this->intervals
+                                                          : this->prerelease;
+
+    /* Without pre-releases an interval only accepts its releases, so trim
+     * pre-releases off its ends, and add back the allowed ones. */
+    std::vector<Interval> accepted = pre;
+    if ( ! includePrerelease )
+      {
+        for ( const Interval & interval : this->intervals )
+          {
+            Interval releases = interval;
+            if ( ( interval.lower.key & 1 ) == 0 )
+              {
+                releases.lower = prereleasesOf( interval.lower ).upper.value();
+              }
+            if ( interval.upper.has_value() )
+              {
+                releases.upper = prereleasesOf( * interval.upper ).lower;
+              }
+            accepted.emplace_back( std::move( releases ) );
+          }
+        accepted = unite( std::move( accepted ) );
+      }
+
+    /* Bridge gaps holding no release, whose pre-releases `prerelease'
+     * excludes anyway. */
+    IntervalSet rsl;
+    for ( Interval & interval : accepted )
+      {
+        if ( ( ! rsl.intervals.empty() ) &&
+             ( ! containsRelease( * rsl.intervals.back().upper
+                                , interval.lower
+                                )
+             )
+           )
+          {
+            rsl.intervals.back().upper = std::move( interval.upper );
+          }
+        else
+          {
+            rsl.intervals.emplace_back( std::move( interval ) );
+          }
+      }
+
+    rsl.prerelease = coversPrereleases( pre, rsl.intervals )
+                     ? rsl.intervals
+                     : prereleasesIn( pre );
+    return rsl;
+  }
+
+
+  /** Fold bytes into a 64 bit FNV-1a hash. */
+    static inline uint64_t
+  fnv1a( uint64_t hash, std::string_view bytes )
+  {
+    for ( const char c : bytes )
+      {
+        hash ^= static_cast<unsigned char>( c );
+        hash *= 0x100000001b3ULL;
+      }
+    return hash;
+  }
+
+
+    uint64_t
+  IntervalSet::hash() const
+  {
+    uint64_t rsl = 0xcbf29ce484222325ULL;
+    for ( const std::vector<Interval> * intervals :
+            { & this->intervals, & this->prerelease }
+        )
+      {
+        for ( const Interval & i : * intervals )
+          {
+            rsl = fnv1a( rsl, i.lower.version );
+            rsl = fnv1a( rsl, i.upper.has_value() ? " <" : " *" );
+            if ( i.upper.has_value() )
+              {
+                rsl = fnv1a( rsl, i.upper->version );
+              }
+            rsl = fnv1a( rsl, "," );
+          }
+        rsl = fnv1a( rsl, "|" );
+      }
+    return rsl;
+  }
+
+
+  /** Compare bounds by their rendered text, consistently with `hash'. */
+    static bool
+  sameIntervals( const std::vector<Interval> & a
+               , const std::vector<Interval> & b
+               )
+  {
+    return std::equal( a.cbegin(), a.cend(), b.cbegin(), b.cend()
+                     , []( const Interval & x, const Interval & y )
+                       {
+                         return ( x.lower.version == y.lower.version ) &&
+                                ( x.upper.has_value() ==
+                                  y.upper.has_value()
+                                ) &&
+                                ( ( ! x.upper.has_value() ) ||
+                                  ( x.upper->version == y.upper->version )
+                                );
+                       }
+                     );
+  }
+
+
+    bool
+  IntervalSet::operator==( const IntervalSet & other ) const
+  {
+    return sameIntervals( this->intervals, other.intervals ) &&
+           sameIntervals( this->prerelease, other.prerelease );
+  }
+
+
+    bool
+  IntervalSet::acceptsNothing( bool includePrerelease ) const
+  {
+    if ( includePrerelease || this->intervals.empty() )
+      {
+        return this->intervals.empty();
+      }
+    return this->prerelease.empty() &&
+           std::none_of( this->intervals.cbegin(), this->intervals.cend()
+                       , []( const Interval & i )
+                         {
+                           return containsRelease( i.lower, i.upper );
+                         }
+                       );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+  /**
+   * Find the interval which could contain `version': the last one whose lower
+   * bound is not above it.
+   */
+template <typename Version>
+    static bool
+  search( const std::vector<Interval> & intervals, const Version & version )
+  {
+    auto it = std::upper_bound( intervals.cbegin(), intervals.cend(), version
+                              , []( const Version & v, const Interval & i )
+                                {
+                                  return v.compare( i.lower ) < 0;
+                                }
+                              );
+    if ( it == intervals.cbegin() )
+      {
+        return false;
+      }
+    --it;
+    return ( ! it->upper.has_value() ) ||
+           ( version.compare( * it->upper ) < 0 );
+  }
+
+
+    bool
+  IntervalSet::test( const SemVer & version, bool includePrerelease ) const
+  {
+    return search( ( ( ( version.key & 1 ) != 0 ) || includePrerelease )
+                   ? this->intervals
+                   : this->prerelease
+                 , version
+                 );
+  }
+
+
+    bool
+  IntervalSet::test( const SemVerView & version, bool includePrerelease ) const
+  {
+    return search( ( ( ( version.key() & 1 ) != 0 ) || includePrerelease )
+                   ? this->intervals
+                   : this->prerelease
+                 , version
+                 );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,200 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "semver.hh"
+#include "view.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+struct Comparator;
+
+/**
+ * A half-open span of versions, containing every version ordered at or after
+ * `lower' and before `upper', in `SemVer::compare' order.
+ */
+struct Interval {
+
+  /** Inclusive lower bound. */
+  SemVer lower;
+
+  /** Exclusive upper bound, or `std::nullopt' if there is none. */
+  std::optional<SemVer> upper;
+
+  bool contains( const SemVer     & version ) const;
+  bool contains( const SemVerView & version ) const;
+
+};  /* End struct `Interval' */
+
+
+/* -------------------------------------------------------------------------- */
+
+/** The lowest version there is: "0.0.0-0". */
+const SemVer & minVersion();
+
+/**
+ * The version immediately following `version', such that no version can be
+ * ordered between the two.
+ * This is "1.2.4-0" for "1.2.3", and "1.2.3-alpha.0" for "1.2.3-alpha".
+ * Returns `std::nullopt' for the highest release, "4294967295.4294967295.*".
+ */
+std::optional<SemVer> successor( const SemVer & version );
+
+/**
+ * The pre-releases of the main version of `version', from "1.2.3-0" up to but
+ * excluding "1.2.3".
+ */
+Interval prereleasesOf( const SemVer & version );
+
+/**
+ * Normalize intervals into a sorted list of disjoint intervals, merging any
+ * which overlap or touch, and dropping empty ones.
+ */
+std::vector<Interval> unite( std::vector<Interval> intervals );
+
+/** Intersect two sorted lists of disjoint intervals in linear time. */
+std::vector<Interval> intersect( const std::vector<Interval> & a
+                               , const std::vector<Interval> & b
+                               );
+
+/**
+ * Intersect any number of sorted lists of disjoint intervals in one sweep,
+ * using a heap to order the next bound of each list.
+ * This takes O( n log k ) time for k lists of n intervals in total.
+ */
+std::vector<Interval> intersect(
+  const std::vector<const std::vector<Interval> *> & lists
+);
+
+/**
+ * The sorted, disjoint intervals satisfying a single comparator, ignoring
+ * whether it allows pre-releases.
+ */
+std::vector<Interval> intervalsOf( const Comparator & comp );
+
+/** Whether the span from `lower' up to `upper' contains any release. */
+bool containsRelease( const SemVer                & lower
+                    , const std::optional<SemVer> & upper
+                    );
+
+/**
+ * Whether two sorted lists of disjoint intervals share any version, or any
+ * release if `releases' is set.
+ * This is `intersect' without building the result.
+ */
+bool overlaps( const std::vector<Interval> & a
+             , const std::vector<Interval> & b
+             ,       bool                    releases = false
+             );
+
+
+/**
+ * Whether every version in `inner' is also in `outer', both being sorted lists
+ * of disjoint intervals, in linear time.
+ */
+bool covers( const std::vector<Interval> & outer
+           , const std::vector<Interval> & inner
+           );
+
+/** Like `covers', but only considering releases. */
+bool coversReleases( const std::vector<Interval> & outer
+                   , const std::vector<Interval> & inner
+                   );
+
+/** Like `covers', but only considering pre-releases. */
+bool coversPrereleases( const std::vector<Interval> & outer
+                      , const std::vector<Interval> & inner
+                      );
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * The set of versions accepted by a range, compiled from its comparators.
+ *
+ * The `intervals' are those satisfying any of the range's comparator sets,
+ * which is what a range accepts if pre-releases are included.
+ * Otherwise a pre-release version is only accepted if a comparator set
+ * containing it opts in to pre-releases of its main version, by having a
+ * comparator for some pre-release of that main version.
+ * Those allowances are compiled into `prerelease', which is a subset of
+ * `intervals' covering only pre-release versions.
+ */
+struct IntervalSet {
+
+  std::vector<Interval> intervals;
+  std::vector<Interval> prerelease;
+
+  /**
+   * Compile sets of comparators, which are "and"-ed together within a set and
+   * "or"-ed across sets, as `Range::set' is.
+   */
+    static IntervalSet
+  compile( const std::vector<std::vector<Comparator>> & set );
+
+  /** Test membership with a binary search of the relevant intervals. */
+  bool test( const SemVer     & version, bool includePrerelease ) const;
+  bool test( const SemVerView & version, bool includePrerelease ) const;
+
+  /** The intervals which pre-release versions are tested against. */
+    const std::vector<Interval> &
+  prereleaseIntervals( bool includePrerelease ) const
+  {
+    return includePrerelease ? this->intervals : this->prerelease;
+  }
+
+  /** Whether no version is accepted. */
+  bool empty() const { return this->intervals.empty(); }
+
+  /**
+   * The canonical form of the versions accepted under `includePrerelease',
+   * which is equal for, and only for, equivalent ranges.
+   * It is tested with `includePrerelease' unset.
+   * The `intervals' span the accepted versions, bridging gaps which hold only
+   * pre-releases, and `prerelease' holds the accepted pre-releases.
+   * Where every pre-release in `intervals' is accepted, whether by including
+   * pre-releases or by allowing them, `prerelease' is `intervals'.
+   * So "1.2.3-alpha - 1.2.3-beta" is canonically the same with or without
+   * including pre-releases, and "^1.2.0" the same as "1.x >=1.2.0".
+   */
+  IntervalSet canonical( bool includePrerelease ) const;
+
+  /**
+   * A hash of the bounds, which is stable across processes and platforms.
+   * Canonical sets are equal if their hashes are, barring collisions.
+   */
+  uint64_t hash() const;
+
+  /** Whether the bounds are the same, textually. */
+  bool operator==( const IntervalSet & other ) const;
+
+  /**
+   * Whether no version is accepted under `includePrerelease', such as when
+   * the only versions left are pre-releases which are not allowed.
+   */
+  bool acceptsNothing( bool includePrerelease ) const;
+
+};  /* End struct `IntervalSet' */
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -4,6 +4,9 @@
  *
  * -------------------------------------------------------------------------- */
 
+#include <algorithm>
+#include <charconv>
+#include <climits>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
@@ -116,11 +119,13 @@ Range::Range( std::string_view range, bool includePrerelease, bool loose )
   , set()
   , includePrerelease( includePrerelease )
   , loose( loose )
+  , compiled()
 {
   /* Split range string into "statements" ( sub-ranges ) */
   this->splitStatements();
   /* Set `this->range' */
   this->format();
+  this->compiled = IntervalSet::compile( this->set );
 }
 
 
@@ -130,13 +135,15 @@ Range::Range( const Range & range, bool includePrerelease, bool loose )
   , set()
   , includePrerelease( includePrerelease )
   , loose( loose )
+  , compiled()
 {
   if ( ( range.loose == loose ) &&
        ( range.includePrerelease == includePrerelease )
      )
     {
-      this->set   = range.set;
-      this->range = range.range;
+      this->set      = range.set;
+      this->range    = range.range;
+      this->compiled = range.compiled;
     }
   else
     {
@@ -144,6 +151,7 @@ Range::Range( const Range & range, bool includePrerelease, bool loose )
       this->splitStatements();
       /* Set `this->range' */
       this->format();
+      this->compiled = IntervalSet::compile( this->set );
     }
 }
 
@@ -154,6 +162,7 @@ Range::Range( const Comparator & range, bool includePrerelease, bool loose )
   , set( { { range } } )
   , includePrerelease( includePrerelease )
   , loose( loose )
+  , compiled( IntervalSet::compile( this->set ) )
 {
   /* Set `this->range' */
   this->format();
@@ -162,15 +171,686 @@ Range::Range( const Comparator & range, bool includePrerelease, bool loose )
 
 /* -------------------------------------------------------------------------- */
 
+  static Comparator
+makeComparator( std::string_view op, SemVer version, bool includePrerelease
+              , bool loose
+              )
+{
+  return Comparator( op, version, includePrerelease, loose );
+}
+
+
+/** Render comparators accepting exactly the versions of `interval'. */
+  static std::vector<Comparator>
+renderInterval( const Interval & interval, bool includePrerelease, bool loose )
+{
+  const bool fromMin = interval.lower.compare( minVersion() ) == 0;
+  if ( fromMin && ( ! interval.upper.has_value() ) )
+    {
+      return { Comparator( "", includePrerelease, loose ) };
+    }
+
+  /* A single release, "1.2.3" for [1.2.3, 1.2.4-0). */
+  if ( interval.upper.has_value() && ( ( interval.lower.key & 1 ) != 0 ) )
+    {
+      const std::optional<SemVer> next = successor( interval.lower );
+      if ( next.has_value() && ( next->compare( * interval.upper ) == 0 ) )
+        {
+          return { makeComparator( "", interval.lower, includePrerelease
+                                 , loose
+                                 )
+                 };
+        }
+    }
+
+  std::vector<Comparator> rsl;
+  if ( ! fromMin )
+    {
+      rsl.push_back( makeComparator( ">=", interval.lower, includePrerelease
+                                   , loose
+                                   )
+                   );
+    }
+  if ( interval.upper.has_value() )
+    {
+      /* "<=1.2.3-rc" rather than "<1.2.3-rc.0". */
+      const std::vector<std::string> & pre = interval.upper->prerelease;
+      if ( ( 2 <= pre.size() ) && ( pre.back() == "0" ) )
+        {
+          SemVer prev = * interval.upper;
+          prev.prerelease.pop_back();
+          prev.format();
+          rsl.push_back( makeComparator( "<=", std::move( prev )
+                                       , includePrerelease, loose
+                                       )
+                       );
+        }
+      else
+        {
+          rsl.push_back( makeComparator( "<", * interval.upper
+                                       , includePrerelease, loose
+                                       )
+                       );
+        }
+    }
+  return rsl;
+}
+
+
+/**
+ * Render comparator sets accepting the same versions as `compiled' does under
+ * `includePrerelease'.
+ *
+ * With pre-releases included this is one set per interval.
+ * Otherwise the intervals are first trimmed to those versions the range
+ * actually accepts: the releases of each interval, plus its allowed
+ * pre-releases, so "1.2.3 || 1.2.4" renders as ">=1.2.3 <1.2.5-0".
+ * Comparators on pre-release bounds allow pre-releases in their own sets, so
+ * allowances which no bound covers are rendered as sets of their own, as in
+ * ">=1.0.0 <2.0.0-0||>=1.5.0-beta <1.5.0".
+ */
+  static std::vector<std::vector<Comparator>>
+renderIntervals( const IntervalSet & compiled
+               ,       bool          includePrerelease
+               ,       bool          loose
+               )
+{
+  if ( compiled.empty() )
+    {
+      return { { Comparator( "<0.0.0-0", includePrerelease, loose ) } };
+    }
+
+  std::vector<std::vector<Comparator>> rsl;
+  if ( includePrerelease )
+    {
+      for ( const Interval & interval : compiled.intervals )
+        {
+          rsl.emplace_back( renderInterval( interval, true, loose ) );
+        }
+      return rsl;
+    }
+
+  std::vector<Interval> accepted = compiled.prerelease;
+  for ( const Interval & interval : compiled.intervals )
+    {
+      Interval releases = interval;
+      if ( ( ( interval.lower.key & 1 ) == 0 ) &&
+           ( interval.lower.compare( minVersion() ) != 0 )
+         )
+        {
+          releases.lower = SemVer( interval.lower.major, interval.lower.minor
+                                 , interval.lower.patch
+                                 );
+        }
+      if ( interval.upper.has_value() && ( ( interval.upper->key & 1 ) == 0 ) )
+        {
+          releases.upper = prereleasesOf( * interval.upper ).lower;
+        }
+      accepted.emplace_back( std::move( releases ) );
+    }
+  accepted = unite( std::move( accepted ) );
+
+  /* Bridge gaps holding only pre-releases, which are not accepted anyway,
+   * unless a pre-release bound of the bridged interval would allow them. */
+  std::vector<Interval> bridged;
+  for ( Interval & interval : accepted )
+    {
+      if ( ! bridged.empty() )
+        {
+          const VersionKey gap   = interval.lower.key >> 1;
+          const SemVer   & lower = bridged.back().lower;
+          const bool       lowerAllows =
+            ( ( lower.key & 1 ) == 0 ) && ( ( lower.key >> 1 ) == gap ) &&
+            ( lower.compare( minVersion() ) != 0 );
+          const bool       upperAllows =
+            interval.upper.has_value() &&
+            ( ( interval.upper->key & 1 ) == 0 ) &&
+            ( ( interval.upper->key >> 1 ) == gap );
+          const bool       releases =
+            containsRelease( * bridged.back().upper, interval.lower );
+          if ( ( ! releases ) && ( ! lowerAllows ) && ( ! upperAllows ) )
+            {
+              bridged.back().upper = std::move( interval.upper );
+              continue;
+            }
+        }
+      bridged.emplace_back( std::move( interval ) );
+    }
+
+  for ( const Interval & interval : bridged )
+    {
+      rsl.emplace_back( renderInterval( interval, false, loose ) );
+    }
+
+  const IntervalSet rendered = IntervalSet::compile( rsl );
+  for ( const Interval & allowed : compiled.prerelease )
+    {
+      const std::vector<Interval> covered =
+        intersect( { allowed }, rendered.prerelease );
+      if ( ( covered.size() != 1 ) ||
+           ( covered[0].lower.compare( allowed.lower ) != 0 ) ||
+           ( covered[0].upper->compare( * allowed.upper ) != 0 )
+         )
+        {
+          rsl.emplace_back( renderInterval( allowed, false, loose ) );
+        }
+    }
+  return rsl;
+}
+
+
+Range::Range( IntervalSet compiled, bool includePrerelease, bool loose )
+  : raw()
+  , range()
+  , set( renderIntervals( compiled, includePrerelease, loose ) )
+  , includePrerelease( includePrerelease )
+  , loose( loose )
+  , compiled( std::move( compiled ) )
+{
+  /* Set `this->range' */
+  this->raw = this->format();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Patterns used to desugar ranges, compiled once for each of the strict and
+ * loose grammars.
+ */
+struct RangePatterns {
+
+  std::regex hyphen;
+  std::regex comparatorTrim;
+  std::regex tildeTrim;
+  std::regex caretTrim;
+  std::regex tilde;
+  std::regex caret;
+  std::regex xRange;
+  std::regex star;
+  std::regex gte0;
+  std::regex gte0Pre;
+  std::regex comparator;
+
+  RangePatterns( bool loose )
+    : hyphen( loose ? re::HYPHENRANGELOOSE : re::HYPHENRANGE )
+    , comparatorTrim( re::COMPARATORTRIM )
+    , tildeTrim( re::TILDETRIM )
+    , caretTrim( re::CARETTRIM )
+    , tilde( loose ? re::TILDELOOSE : re::TILDE )
+    , caret( loose ? re::CARETLOOSE : re::CARET )
+    , xRange( loose ? re::XRANGELOOSE : re::XRANGE )
+    , star( re::STAR )
+    , gte0( re::GTE0 )
+    , gte0Pre( re::GTE0PRE )
+    , comparator( loose ? re::COMPARATORLOOSE : re::COMPARATOR )
+  {}
+
+};  /* End struct `RangePatterns' */
+
+
+  static const RangePatterns &
+rangePatterns( bool loose )
+{
+  static const RangePatterns strict( false );
+  static const RangePatterns loosePatterns( true );
+  return loose ? loosePatterns : strict;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static std::string
+trim( std::string_view s )
+{
+  static const char * ws = " \t\n\v\f\r";
+  const size_t begin = s.find_first_not_of( ws );
+  if ( begin == std::string_view::npos )
+    {
+      return "";
+    }
+  return std::string( s.substr( begin, s.find_last_not_of( ws ) - begin + 1 ) );
+}
+
+
+/**
+ * Split on runs of whitespace, keeping empty leading and trailing fields the
+ * way the reference implementation's `split( /\s+/ )' does.
+ */
+  static std::vector<std::string>
+splitSpaces( const std::string & s )
+{
+  static const char * ws = " \t\n\v\f\r";
+  std::vector<std::string> rsl;
+  size_t begin = 0;
+  while ( true )
+    {
+      const size_t end = s.find_first_of( ws, begin );
+      rsl.emplace_back( s.substr( begin, end - begin ) );
+      if ( end == std::string::npos )
+        {
+          return rsl;
+        }
+      begin = s.find_first_not_of( ws, end );
+      if ( begin == std::string::npos )
+        {
+          rsl.emplace_back();
+          return rsl;
+        }
+    }
+}
+
+
+/**
+ * Apply `replace' to each whitespace separated field of `s', rejoining them
+ * with single spaces.
+ */
+template <typename Replace>
+  static std::string
+mapSpaces( const std::string & s, Replace replace )
+{
+  const std::vector<std::string> fields = splitSpaces( s );
+  std::string                    rsl;
+  for ( auto i = fields.cbegin(); i != fields.cend(); ++i )
+    {
+      if ( i != fields.cbegin() )
+        {
+          rsl += " ";
+        }
+      rsl += replace( * i );
+    }
+  return rsl;
+}
+
+
+/** Whether a version part is a wildcard, or missing. */
+  static inline bool
+isX( const std::ssub_match & id )
+{
+  return ( ! id.matched ) || ( id.length() == 0 ) || ( id == "x" ) ||
+         ( id == "X" ) || ( id == "*" );
+}
+
+
+/** Increment a numeric version part. */
+  static std::string
+inc( const std::ssub_match & id )
+{
+  unsigned long n = 0;
+  const std::string s = id.str();
+  const auto [ptr, ec] = std::from_chars( s.data(), s.data() + s.size(), n );
+  if ( ( ec != std::errc() ) || ( ptr != ( s.data() + s.size() ) ) ||
+       ( UINT_MAX <= n )
+     )
+    {
+      throw std::invalid_argument(
+        "Invalid version part in range: '" + s + "'"
+      );
+    }
+  return std::to_string( n + 1 );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Desugar hyphen ranges.
+ *   "1.2 - 3.4.5" => ">=1.2.0 <=3.4.5"
+ *   "1.2.3 - 3.4" => ">=1.2.3 <3.5.0-0"
+ */
+  static std::string
+replaceHyphen( const std::smatch & m, bool includePrerelease )
+{
+  const char * z = includePrerelease ? "-0" : "";
+  std::string  from;
+  std::string  to;
+
+  if ( isX( m[2] ) )
+    {
+      from = "";
+    }
+  else if ( isX( m[3] ) )
+    {
+      from = ">=" + m[2].str() + ".0.0" + z;
+    }
+  else if ( isX( m[4] ) )
+    {
+      from = ">=" + m[2].str() + "." + m[3].str() + ".0" + z;
+    }
+  else if ( m[5].matched )
+    {
+      from = ">=" + m[1].str();
+    }
+  else
+    {
+      from = ">=" + m[1].str() + z;
+    }
+
+  if ( isX( m[8] ) )
+    {
+      to = "";
+    }
+  else if ( isX( m[9] ) )
+    {
+      to = "<" + inc( m[8] ) + ".0.0-0";
+    }
+  else if ( isX( m[10] ) )
+    {
+      to = "<" + m[8].str() + "." + inc( m[9] ) + ".0-0";
+    }
+  else if ( m[11].matched )
+    {
+      to = "<=" + m[8].str() + "." + m[9].str() + "." + m[10].str() + "-" +
+           m[11].str();
+    }
+  else if ( includePrerelease )
+    {
+      to = "<" + m[8].str() + "." + m[9].str() + "." + inc( m[10] ) + "-0";
+    }
+  else
+    {
+      to = "<=" + m[7].str();
+    }
+
+  return trim( from + " " + to );
+}
+
+
+/**
+ * Desugar a tilde range.
+ *   "~1"     => ">=1.0.0 <2.0.0-0"
+ *   "~1.2"   => ">=1.2.0 <1.3.0-0"
+ *   "~1.2.3" => ">=1.2.3 <1.3.0-0"
+ */
+  static std::string
+replaceTilde( const std::string & comp, const std::regex & pattern )
+{
+  std::smatch m;
+  if ( ! std::regex_match( comp, m, pattern ) )
+    {
+      return comp;
+    }
+  const std::string M = m[1].str();
+  if ( isX( m[1] ) )
+    {
+      return "";
+    }
+  if ( isX( m[2] ) )
+    {
+      return ">=" + M + ".0.0 <" + inc( m[1] ) + ".0.0-0";
+    }
+  const std::string mi = m[2].str();
+  if ( isX( m[3] ) )
+    {
+      return ">=" + M + "." + mi + ".0 <" + M + "." + inc( m[2] ) + ".0-0";
+    }
+  const std::string pre = m[4].matched ? ( "-" + m[4].str() ) : "";
+  return ">=" + M + "." + mi + "." + m[3].str() + pre + " <" + M + "." +
+         inc( m[2] ) + ".0-0";
+}
+
+
+/**
+ * Desugar a caret range, which allows changes that do not modify the left-most
+ * non-zero version part.
+ *   "^1.2.3" => ">=1.2.3 <2.0.0-0"
+ *   "^0.2.3" => ">=0.2.3 <0.3.0-0"
+ *   "^0.0.3" => ">=0.0.3 <0.0.4-0"
+ */
+  static std::string
+replaceCaret( const std::string & comp
+            , const std::regex  & pattern
+            ,       bool          includePrerelease
+            )
+{
+  std::smatch m;
+  if ( ! std::regex_match( comp, m, pattern ) )
+    {
+      return comp;
+    }
+  const char * z = includePrerelease ? "-0" : "";
+  if ( isX( m[1] ) )
+    {
+      return "";
+    }
+  const std::string M = m[1].str();
+  if ( isX( m[2] ) )
+    {
+      return ">=" + M + ".0.0" + z + " <" + inc( m[1] ) + ".0.0-0";
+    }
+  const std::string mi = m[2].str();
+  if ( isX( m[3] ) )
+    {
+      const std::string upper = ( M == "0" )
+                                ? ( M + "." + inc( m[2] ) + ".0-0" )
+                                : ( inc( m[1] ) + ".0.0-0" );
+      return ">=" + M + "." + mi + ".0" + z + " <" + upper;
+    }
+
+  const std::string p = m[3].str();
+  std::string upper;
+  if ( M != "0" )
+    {
+      upper = inc( m[1] ) + ".0.0-0";
+    }
+  else if ( mi != "0" )
+    {
+      upper = M + "." + inc( m[2] ) + ".0-0";
+    }
+  else
+    {
+      upper = M + "." + mi + "." + inc( m[3] ) + "-0";
+    }
+
+  if ( m[4].matched )
+    {
+      return ">=" + M + "." + mi + "." + p + "-" + m[4].str() + " <" + upper;
+    }
+  /* Only zero majors get the "-0" lower bound; "^1.2.3" excludes pre-releases
+   * of "1.2.3" even when they are included. */
+  return ">=" + M + "." + mi + "." + p + ( ( M == "0" ) ? z : "" ) + " <" +
+         upper;
+}
+
+
+/**
+ * Desugar an X-range, or a comparator on a partial version.
+ *   "1.2.x" => ">=1.2.0 <1.3.0-0"
+ *   ">1.2"  => ">=1.3.0"
+ *   "<=1"   => "<2.0.0-0"
+ */
+  static std::string
+replaceXRange( const std::string & field
+             , const std::regex  & pattern
+             ,       bool          includePrerelease
+             )
+{
+  const std::string comp = trim( field );
+  std::smatch       m;
+  if ( ! std::regex_match( comp, m, pattern ) )
+    {
+      return comp;
+    }
+
+  std::string gtlt = m[1].str();
+  const bool  xM   = isX( m[2] );
+  const bool  xm   = xM || isX( m[3] );
+  const bool  xp   = xm || isX( m[4] );
+
+  if ( ( gtlt == "=" ) && xp )
+    {
+      gtlt = "";
+    }
+
+  /* The lowest possible pre-release, if pre-releases are included. */
+  std::string pr = includePrerelease ? "-0" : "";
+
+  if ( xM )
+    {
+      /* Nothing is allowed, or nothing is forbidden. */
+      return ( ( gtlt == ">" ) || ( gtlt == "<" ) ) ? "<0.0.0-0" : "*";
+    }
+
+  if ( ( ! gtlt.empty() ) && xp )
+    {
+      std::string M  = m[2].str();
+      std::string mi = xm ? "0" : m[3].str();
+      if ( gtlt == ">" )
+        {
+          /* ">1" => ">=2.0.0", ">1.2" => ">=1.3.0" */
+          gtlt = ">=";
+          if ( xm )
+            {
+              M  = inc( m[2] );
+              mi = "0";
+            }
+          else
+            {
+              mi = inc( m[3] );
+            }
+        }
+      else if ( gtlt == "<=" )
+        {
+          /* "<=0.7.x" is actually "<0.8.0", since any 0.7.x should pass. */
+          gtlt = "<";
+          if ( xm )
+            {
+              M = inc( m[2] );
+            }
+          else
+            {
+              mi = inc( m[3] );
+            }
+        }
+
+      if ( gtlt == "<" )
+        {
+          pr = "-0";
+        }
+      return gtlt + M + "." + mi + ".0" + pr;
+    }
+
+  if ( xm )
+    {
+      return ">=" + m[2].str() + ".0.0" + pr + " <" + inc( m[2] ) + ".0.0-0";
+    }
+
+  if ( xp )
+    {
+      return ">=" + m[2].str() + "." + m[3].str() + ".0" + pr + " <" +
+             m[2].str() + "." + inc( m[3] ) + ".0-0";
+    }
+
+  return comp;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Desugar a range without any "||" into primitive comparators, following the
+ * reference implementation's sequence of rewrites.
+ */
   std::vector<Comparator>
 Range::parseRange( std::string_view range )
 {
-  const std::regex hyphen_re(
-    this->loose ? re::HYPHENRANGELOOSE : re::HYPHENRANGE
-  );
+  const RangePatterns & p = rangePatterns( this->loose );
+
+  std::string r = trim( range );
+
   /* `1.2.3 - 1.2.4` => `>=1.2.3 <=1.2.4` */
-  // FIXME: they use regex replacement but that's kind of wasteful.
-  return {};  // FIXME
+  std::smatch m;
+  if ( std::regex_match( r, m, p.hyphen ) )
+    {
+      r = replaceHyphen( m, this->includePrerelease );
+    }
+  /* `> 1.2.3 < 1.2.5` => `>1.2.3 <1.2.5` */
+  r = std::regex_replace( r, p.comparatorTrim, re::comparatorTrimReplace );
+  /* `~ 1.2.3` => `~1.2.3` */
+  r = std::regex_replace( r, p.tildeTrim, re::tildeTrimReplace );
+  /* `^ 1.2.3` => `^1.2.3` */
+  r = std::regex_replace( r, p.caretTrim, re::caretTrimReplace );
+
+  /* Desugar each space separated comparator. */
+  std::string desugared;
+  size_t      begin = 0;
+  for ( bool first = true; begin <= r.size(); first = false )
+    {
+      size_t end = r.find( ' ', begin );
+      if ( end == std::string::npos )
+        {
+          end = r.size();
+        }
+      std::string comp = r.substr( begin, end - begin );
+      begin = end + 1;
+
+      comp = mapSpaces( trim( comp ), [&]( const std::string & c ) {
+        return replaceCaret( c, p.caret, this->includePrerelease );
+      } );
+      comp = mapSpaces( trim( comp ), [&]( const std::string & c ) {
+        return replaceTilde( c, p.tilde );
+      } );
+      comp = mapSpaces( comp, [&]( const std::string & c ) {
+        return replaceXRange( c, p.xRange, this->includePrerelease );
+      } );
+      /* "*" is "and"-ed with everything else, so it can just be dropped. */
+      comp = std::regex_replace( trim( comp ), p.star, ""
+                               , std::regex_constants::format_first_only
+                               );
+
+      if ( ! first )
+        {
+          desugared += " ";
+        }
+      desugared += comp;
+    }
+
+  std::vector<Comparator> comps;
+  for ( std::string comp : splitSpaces( desugared ) )
+    {
+      /* ">=0.0.0" is equivalent to "*". */
+      comp = trim( comp );
+      if ( std::regex_match( comp, this->includePrerelease ? p.gte0Pre
+                                                           : p.gte0
+                           )
+         )
+        {
+          comp = "";
+        }
+
+      /* In loose mode invalid comparators are dropped. */
+      if ( this->loose && ( ! std::regex_match( comp, p.comparator ) ) )
+        {
+          continue;
+        }
+
+      Comparator c( comp, this->includePrerelease, this->loose );
+      /* A null set makes the whole statement a null set. */
+      if ( isNullSet( c ) )
+        {
+          return { c };
+        }
+      const bool seen = std::any_of( comps.cbegin(), comps.cend()
+                                   , [&]( const Comparator & o )
+                                     {
+                                       return o.value == c.value;
+                                     }
+                                   );
+      if ( ! seen )
+        {
+          comps.emplace_back( std::move( c ) );
+        }
+    }
+
+  /* "*" is redundant alongside any other comparator. */
+  if ( 1 < comps.size() )
+    {
+      comps.erase( std::remove_if( comps.begin(), comps.end(), isAny )
+                 , comps.end()
+                 );
+    }
+
+  return comps;
 }
 
 
@@ -178,24 +858,281 @@ Range::parseRange( std::string_view range )
 
     /* Comparators */
 
+  Range
+Range::intersect( const Range & other ) const
+{
+  const bool a = this->includePrerelease;
+  const bool b = other.includePrerelease;
+
+  IntervalSet rsl;
+  rsl.intervals = semi::intersect( this->compiled.intervals
+                                 , other.compiled.intervals
+                                 );
+  rsl.prerelease = ( a && b )
+    ? semi::intersect( this->compiled.prerelease, other.compiled.prerelease )
+    : semi::intersect( this->compiled.prereleaseIntervals( a )
+                     , other.compiled.prereleaseIntervals( b )
+                     );
+  return Range( std::move( rsl ), a && b, this->loose && other.loose );
+}
+
+
+/**
+ * Intersect the ranges of `ranges' whose indices are in `indices', as
+ * `Range::intersect' does.
+ */
+  static IntervalSet
+intersectAll( std::span<const Range>      ranges
+            , const std::vector<size_t> & indices
+            ,       bool                  includePrerelease
+            )
+{
+  std::vector<const std::vector<Interval> *> intervals;
+  std::vector<const std::vector<Interval> *> prerelease;
+  intervals.reserve( indices.size() );
+  prerelease.reserve( indices.size() );
+  for ( size_t i : indices )
+    {
+      const Range & r = ranges[i];
+      intervals.push_back( & r.compiled.intervals );
+      prerelease.push_back( includePrerelease
+                            ? & r.compiled.prerelease
+                            : & r.compiled.prereleaseIntervals(
+                                  r.includePrerelease
+                                )
+                          );
+    }
+  IntervalSet rsl;
+  rsl.intervals  = intersect( intervals );
+  rsl.prerelease = intersect( prerelease );
+  return rsl;
+}
+
+
+  Range
+Range::intersect( std::span<const Range>   ranges
+                , std::vector<size_t>    * conflict
+                )
+{
+  bool includePrerelease = true;
+  bool loose             = true;
+  for ( const Range & r : ranges )
+    {
+      includePrerelease = includePrerelease && r.includePrerelease;
+      loose             = loose && r.loose;
+    }
+
+  std::vector<size_t> indices( ranges.size() );
+  for ( size_t i = 0; i < indices.size(); ++i )
+    {
+      indices[i] = i;
+    }
+  IntervalSet rsl = intersectAll( ranges, indices, includePrerelease );
+
+  if ( conflict != nullptr )
+    {
+      conflict->clear();
+      if ( rsl.acceptsNothing( includePrerelease ) )
+        {
+          /* Deletion filtering: drop each range whose removal still leaves
+           * nothing accepted, which leaves a minimal conflicting subset. */
+          for ( size_t i = 0; i < indices.size(); )
+            {
+              std::vector<size_t> rest = indices;
+              rest.erase( rest.begin() + i );
+              bool restIncludePrerelease = true;
+              for ( size_t j : rest )
+                {
+                  restIncludePrerelease =
+                    restIncludePrerelease && ranges[j].includePrerelease;
+                }
+              if ( intersectAll( ranges, rest, restIncludePrerelease )
+                     .acceptsNothing( restIncludePrerelease )
+                 )
+                {
+                  indices = std::move( rest );
+                }
+              else
+                {
+                  ++i;
+                }
+            }
+          * conflict = std::move( indices );
+        }
+    }
+
+  return Range( std::move( rsl ), includePrerelease, loose );
+}
+
+
+  IntervalSet
+Range::canonical() const
+{
+  return this->compiled.canonical( this->includePrerelease );
+}
+
+
   bool
-Range::intersects( const Range & other ) const
+Range::operator==( const Range & other ) const
+{
+  return ( this->includePrerelease == other.includePrerelease ) &&
+         ( this->set == other.set );
+}
+
+
+  uint64_t
+Range::hash() const
+{
+  uint64_t rsl = this->includePrerelease ? 1 : 0;
+  for ( const std::vector<Comparator> & comps : this->set )
+    {
+      /* Mark where each set ends, so "a b || c" differs from "a || b c". */
+      rsl = hashCombine( rsl, comps.size() );
+      for ( const Comparator & comp : comps )
+        {
+          rsl = hashCombine( rsl, comp.hash() );
+        }
+    }
+  return rsl;
+}
+
+
+  Range
+Range::simplify() const
 {
-  return false; // FIXME
+  return Range( this->compiled, this->includePrerelease, this->loose );
+}
+
+
+  Range
+Range::simplify( const std::vector<SemVer> & versions ) const
+{
+  std::vector<const SemVer *> sorted;
+  sorted.reserve( versions.size() );
+  for ( const SemVer & version : versions )
+    {
+      sorted.push_back( & version );
+    }
+  std::stable_sort( sorted.begin(), sorted.end()
+                  , []( const SemVer * a, const SemVer * b )
+                    {
+                      return a->compare( * b ) < 0;
+                    }
+                  );
+
+  /* Runs of consecutive accepted versions, with an open ended last run. */
+  std::vector<std::pair<const SemVer *, const SemVer *>> runs;
+  const SemVer * first = nullptr;
+  const SemVer * prev  = nullptr;
+  for ( const SemVer * version : sorted )
+    {
+      if ( this->test( * version ) )
+        {
+          prev  = version;
+          first = ( first == nullptr ) ? version : first;
+        }
+      else if ( prev != nullptr )
+        {
+          runs.emplace_back( first, prev );
+          first = nullptr;
+          prev  = nullptr;
+        }
+    }
+  if ( first != nullptr )
+    {
+      runs.emplace_back( first, nullptr );
+    }
+
+  std::string simplified = runs.empty() ? "<0.0.0-0" : "";
+  for ( const auto & [min, max] : runs )
+    {
+      if ( ! simplified.empty() )
+        {
+          simplified += " || ";
+        }
+      if ( min == max )
+        {
+          simplified += min->toString();
+        }
+      else if ( ( max == nullptr ) && ( min == sorted.front() ) )
+        {
+          simplified += "*";
+        }
+      else if ( max == nullptr )
+        {
+          simplified += ">=" + min->toString();
+        }
+      else if ( min == sorted.front() )
+        {
+          simplified += "<=" + max->toString();
+        }
+      else
+        {
+          simplified += min->toString() + " - " + max->toString();
+        }
+    }
+
+  if ( simplified.size() < this->raw.size() )
+    {
+      return Range( simplified, this->includePrerelease, this->loose );
+    }
+  return * this;
+}
+
+
+  bool
+Range::intersects( const Range & other, bool includePrerelease ) const
+{
+  const bool a = includePrerelease || this->includePrerelease;
+  const bool b = includePrerelease || other.includePrerelease;
+
+  /* Releases are accepted anywhere in the intervals, while pre-releases need
+   * to be allowed by both ranges. */
+  return overlaps( this->compiled.intervals, other.compiled.intervals
+                 , ! ( a && b )
+                 ) ||
+         overlaps( this->compiled.prereleaseIntervals( a )
+                 , other.compiled.prereleaseIntervals( b )
+                 );
 }
 
 
   bool
 Range::test( std::string_view comp, bool includePrerelease, bool loose ) const
 {
-  return false; // FIXME
+  const std::optional<SemVerView> version =
+    SemVerView::parse( comp, loose || this->loose );
+  return version.has_value() && this->test( * version, includePrerelease );
+}
+
+
+  bool
+Range::test( const SemVer & semver, bool includePrerelease, bool ) const
+{
+  return this->compiled.test( semver
+                            , includePrerelease || this->includePrerelease
+                            );
 }
 
 
   bool
-Range::test( const SemVer & semver, bool includePrerelease, bool loose ) const
+Range::test( const SemVerView & semver, bool includePrerelease ) const
 {
-  return false; // FIXME
+  return this->compiled.test( semver
+                            , includePrerelease || this->includePrerelease
+                            );
+}
+
+
+  void
+Range::test( const VersionColumns      & versions
+           ,       std::span<uint64_t>   matches
+           ,       bool                  includePrerelease
+           ) const
+{
+  testColumns( this->compiled, versions, matches
+             , includePrerelease || this->includePrerelease
+             );
 }
 
 
@@ -233,6 +1170,244 @@ Range::toString() const
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+  bool
+subset( const Range & sub, const Range & dom, bool includePrerelease )
+{
+  const bool a = includePrerelease || sub.includePrerelease;
+  const bool b = includePrerelease || dom.includePrerelease;
+
+  if ( a && b )
+    {
+      return covers( dom.compiled.intervals, sub.compiled.intervals );
+    }
+
+  /* Releases are accepted anywhere in a range's intervals, while
+   * pre-releases accepted by `sub' need to be allowed by `dom'. */
+  if ( ! coversReleases( dom.compiled.intervals, sub.compiled.intervals ) )
+    {
+      return false;
+    }
+  return a ? coversPrereleases( dom.compiled.prerelease
+                              , sub.compiled.intervals
+                              )
+           : covers( dom.compiled.prereleaseIntervals( b )
+                   , sub.compiled.prerelease
+                   );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  const SemVer *
+maxSatisfying( std::span<const SemVer>   versions
+             , const Range             & range
+             ,       bool                includePrerelease
+             )
+{
+  const SemVer * rsl = nullptr;
+  for ( const SemVer & v : versions )
+    {
+      if ( ( ( rsl == nullptr ) || ( rsl->compare( v ) < 0 ) ) &&
+           range.test( v, includePrerelease )
+         )
+        {
+          rsl = & v;
+        }
+    }
+  return rsl;
+}
+
+
+  const SemVer *
+minSatisfying( std::span<const SemVer>   versions
+             , const Range             & range
+             ,       bool                includePrerelease
+             )
+{
+  const SemVer * rsl = nullptr;
+  for ( const SemVer & v : versions )
+    {
+      if ( ( ( rsl == nullptr ) || ( 0 < rsl->compare( v ) ) ) &&
+           range.test( v, includePrerelease )
+         )
+        {
+          rsl = & v;
+        }
+    }
+  return rsl;
+}
+
+
+/** The index of the first of `versions[first, last)' at or after `bound'. */
+  static size_t
+lowerBound( std::span<const SemVer>   versions
+          , size_t                    first
+          , size_t                    last
+          , const SemVer            & bound
+          )
+{
+  return std::lower_bound( versions.begin() + first, versions.begin() + last
+                         , bound
+                         , []( const SemVer & v, const SemVer & b )
+                           {
+                             return v.compare( b ) < 0;
+                           }
+                         ) - versions.begin();
+}
+
+
+/** The span of sorted `versions' within `interval'. */
+  static std::pair<size_t, size_t>
+spanOf( std::span<const SemVer> versions, const Interval & interval )
+{
+  const size_t lo = lowerBound( versions, 0, versions.size(), interval.lower );
+  const size_t hi = interval.upper.has_value()
+                    ? lowerBound( versions, lo, versions.size()
+                                , * interval.upper
+                                )
+                    : versions.size();
+  return { lo, hi };
+}
+
+
+/**
+ * The highest of sorted `versions' in `intervals', skipping pre-releases if
+ * `releasesOnly' is set.
+ */
+  static const SemVer *
+highestIn( std::span<const SemVer>       versions
+         , const std::vector<Interval> & intervals
+         ,       bool                    releasesOnly
+         )
+{
+  for ( auto i = intervals.crbegin(); i != intervals.crend(); ++i )
+    {
+      auto [lo, hi] = spanOf( versions, * i );
+      while ( lo < hi )
+        {
+          const SemVer & v = versions[hi - 1];
+          if ( ( ! releasesOnly ) || ( ( v.key & 1 ) != 0 ) )
+            {
+              /* The first of equal versions, as the linear search finds. */
+              return & versions[lowerBound( versions, lo, hi - 1, v )];
+            }
+          /* Skip below this main version's pre-releases. */
+          hi = lowerBound( versions, lo, hi - 1, prereleasesOf( v ).lower );
+        }
+    }
+  return nullptr;
+}
+
+
+/** Like `highestIn', but for the lowest version. */
+  static const SemVer *
+lowestIn( std::span<const SemVer>       versions
+        , const std::vector<Interval> & intervals
+        ,       bool                    releasesOnly
+        )
+{
+  for ( const Interval & i : intervals )
+    {
+      auto [lo, hi] = spanOf( versions, i );
+      while ( lo < hi )
+        {
+          const SemVer & v = versions[lo];
+          if ( ( ! releasesOnly ) || ( ( v.key & 1 ) != 0 ) )
+            {
+              return & v;
+            }
+          /* Skip past this main version's pre-releases, to its release. */
+          lo = lowerBound( versions, lo + 1, hi, * prereleasesOf( v ).upper );
+        }
+    }
+  return nullptr;
+}
+
+
+  const SemVer *
+maxSatisfyingSorted( std::span<const SemVer>   versions
+                   , const Range             & range
+                   ,       bool                includePrerelease
+                   )
+{
+  const IntervalSet & set = range.compiled;
+  if ( includePrerelease || range.includePrerelease )
+    {
+      return highestIn( versions, set.intervals, false );
+    }
+  const SemVer * release    = highestIn( versions, set.intervals, true );
+  const SemVer * prerelease = highestIn( versions, set.prerelease, false );
+  if ( ( release == nullptr ) || ( prerelease == nullptr ) )
+    {
+      return ( release == nullptr ) ? prerelease : release;
+    }
+  return ( release->compare( * prerelease ) < 0 ) ? prerelease : release;
+}
+
+
+  const SemVer *
+minSatisfyingSorted( std::span<const SemVer>   versions
+                   , const Range             & range
+                   ,       bool                includePrerelease
+                   )
+{
+  const IntervalSet & set = range.compiled;
+  if ( includePrerelease || range.includePrerelease )
+    {
+      return lowestIn( versions, set.intervals, false );
+    }
+  const SemVer * release    = lowestIn( versions, set.intervals, true );
+  const SemVer * prerelease = lowestIn( versions, set.prerelease, false );
+  if ( ( release == nullptr ) || ( prerelease == nullptr ) )
+    {
+      return ( release == nullptr ) ? prerelease : release;
+    }
+  return ( prerelease->compare( * release ) < 0 ) ? prerelease : release;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  std::optional<SemVer>
+minVersion( const Range & range )
+{
+  const IntervalSet & set = range.compiled;
+  if ( range.includePrerelease )
+    {
+      if ( set.intervals.empty() )
+        {
+          return std::nullopt;
+        }
+      return set.intervals.front().lower;
+    }
+
+  /* The lowest release is the first interval's lower bound, or the release
+   * of its main version, in the first interval containing any release. */
+  std::optional<SemVer> rsl;
+  for ( const Interval & i : set.intervals )
+    {
+      if ( containsRelease( i.lower, i.upper ) )
+        {
+          rsl = ( ( i.lower.key & 1 ) != 0 )
+                ? i.lower
+                : * prereleasesOf( i.lower ).upper;
+          break;
+        }
+    }
+  if ( ( ! set.prerelease.empty() ) &&
+       ( ( ! rsl.has_value() ) ||
+         ( set.prerelease.front().lower.compare( * rsl ) < 0 )
+       )
+     )
+    {
+      rsl = set.prerelease.front().lower;
+    }
+  return rsl;
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 }  /* End Namespace `semi' */
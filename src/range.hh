@@ -6,10 +6,14 @@
 
 #pragma once
 
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
+#include "columns.hh"
 #include "comparator.hh"
+#include "interval.hh"
 #include "semver.hh"
 
 /* -------------------------------------------------------------------------- */
@@ -57,6 +61,12 @@ struct Range {
      */
     bool loose;
 
+    /**
+     * The versions accepted by `set', compiled into sorted intervals so that
+     * testing a version is a binary search.
+     */
+    IntervalSet compiled;
+
 
 /* -------------------------------------------------------------------------- */
 
@@ -65,8 +75,19 @@ struct Range {
          , bool             loose             = false
          );
 
+    Range( const Range &  range ) = default;
+    Range(       Range && range ) = default;
+
+    Range & operator=( const Range &  range ) = default;
+    Range & operator=(       Range && range ) = default;
+
+    /**
+     * Reinterpret a range with other options.
+     * Options are not defaulted here so that this is not used in place of the
+     * copy constructor, which keeps them.
+     */
     Range( const Range & range
-         ,       bool    includePrerelease = false
+         ,       bool    includePrerelease
          ,       bool    loose             = false
          );
 
@@ -80,7 +101,70 @@ struct Range {
 
     /* Comparators */
 
-    bool intersects( const Range & other ) const;
+    /**
+     * The range accepting exactly the versions accepted by both ranges,
+     * computed by merging their intervals in linear time.
+     * Pre-releases are only included in the result if both ranges include
+     * them.
+     */
+    Range intersect( const Range & other ) const;
+
+    /**
+     * An equivalent range with the fewest comparator sets, one for each
+     * disjoint interval of accepted versions, plus any needed to allow
+     * pre-releases.
+     */
+    Range simplify() const;
+
+    /**
+     * A range accepting the same subset of `versions', in the style of
+     * node-semver's `simplifyRange', such as "1.0.0 - 1.0.4 || >=2.1.0".
+     * Unlike `simplify' this is only equivalent over `versions', and this
+     * range is returned as is unless the result is shorter.
+     * If no version is accepted the result is "<0.0.0-0".
+     */
+    Range simplify( const std::vector<SemVer> & versions ) const;
+
+    /**
+     * The range accepting exactly the versions accepted by all of `ranges',
+     * merging their intervals in a single sweep.
+     * Pre-releases are only included in the result if all ranges include
+     * them, and the intersection of no ranges accepts everything.
+     *
+     * If `conflict' is given it is cleared, and if no version is accepted it
+     * is filled with the indices of a minimal subset of `ranges' which accepts
+     * no version either: removing any one of them would leave ranges which
+     * accept some version.
+     */
+      static Range
+    intersect( std::span<const Range>   ranges
+             , std::vector<size_t>    * conflict = nullptr
+             );
+
+    /**
+     * The canonical form of the versions this range accepts, which is equal
+     * for equivalent ranges, such as "^1.2.0" and ">=1.2.0 <2.0.0-0".
+     */
+    IntervalSet canonical() const;
+
+    /**
+     * Whether ranges are written alike: with equal comparators, set by set,
+     * and the same `includePrerelease'.
+     * Equivalent ranges written differently, such as "1.x || 2.x" and
+     * "2.x || 1.x", are not equal; compare their `canonical' forms for that.
+     */
+    bool operator==( const Range & other ) const;
+
+    /** A hash consistent with `operator=='. */
+    uint64_t hash() const;
+
+    /**
+     * Whether any version is accepted by both ranges.
+     * Like `intersect', but without building the result.
+     */
+    bool intersects( const Range & other
+                   , bool          includePrerelease = false
+                   ) const;
 
     bool test( std::string_view comp
              , bool             includePrerelease = false
@@ -92,6 +176,19 @@ struct Range {
              ,       bool     loose             = false
              ) const;
 
+    bool test( const SemVerView & semver
+             ,       bool         includePrerelease = false
+             ) const;
+
+    /**
+     * Test every version in `versions' at once, setting bit i % 64 of
+     * `matches[i / 64]' if version i is accepted, as `testColumns' does.
+     */
+    void test( const VersionColumns      & versions
+             ,       std::span<uint64_t>   matches
+             ,       bool                  includePrerelease = false
+             ) const;
+
 
 /* -------------------------------------------------------------------------- */
 
@@ -108,6 +205,15 @@ struct Range {
 
   private:
 
+    /**
+     * Construct a range from its compiled intervals, rendering comparators
+     * which accept the same versions under `includePrerelease'.
+     */
+    Range( IntervalSet compiled
+         , bool        includePrerelease
+         , bool        loose
+         );
+
     void splitStatements();
 
     std::vector<Comparator> parseRange( std::string_view range );
@@ -118,10 +224,89 @@ struct Range {
 };  /* End struct `Range' */
 
 
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Whether every version accepted by `sub' is also accepted by `dom'.
+ * Each range accepts pre-releases as `Range::test' does, with
+ * `includePrerelease' applying to both.
+ * This compares their compiled intervals in linear time.
+ */
+bool subset( const Range & sub
+           , const Range & dom
+           ,       bool    includePrerelease = false
+           );
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * The highest of `versions' accepted by `range', testing each one as
+ * `Range::test' does, or `nullptr' if none are.
+ * The first of equal versions is returned, as node-semver does.
+ */
+  const SemVer *
+maxSatisfying( std::span<const SemVer>   versions
+             , const Range             & range
+             ,       bool                includePrerelease = false
+             );
+
+/** Like `maxSatisfying', but for the lowest accepted version. */
+  const SemVer *
+minSatisfying( std::span<const SemVer>   versions
+             , const Range             & range
+             ,       bool                includePrerelease = false
+             );
+
+/**
+ * Like `maxSatisfying', for `versions' sorted in ascending
+ * `SemVer::compare' order.
+ * This binary searches for the top of each of the range's intervals in
+ * O( k log n ) time, plus a search to skip past each run of pre-releases
+ * which are not allowed.
+ */
+  const SemVer *
+maxSatisfyingSorted( std::span<const SemVer>   versions
+                   , const Range             & range
+                   ,       bool                includePrerelease = false
+                   );
+
+/** Like `minSatisfying', for sorted `versions'; see `maxSatisfyingSorted'. */
+  const SemVer *
+minSatisfyingSorted( std::span<const SemVer>   versions
+                   , const Range             & range
+                   ,       bool                includePrerelease = false
+                   );
+
+/**
+ * The lowest version which `Range::test' accepts, or `std::nullopt' if it
+ * accepts none.
+ * This differs from node-semver's `minVersion', which does not always return
+ * the lowest accepted version.
+ * Including pre-releases, this is "0.0.0-0" for "*" where node-semver gives
+ * "0.0.0", and "1.2.4-0" for ">1.2.3" where it gives "1.2.4".
+ * And for some ranges which accept versions, such as
+ * "~1.1 || ^0.0.3 ^0.2.1-0 ^0.2 || ^0.0 ^2.1.0", node-semver gives null.
+ */
+std::optional<SemVer> minVersion( const Range & range );
+
+
 /* -------------------------------------------------------------------------- */
 
 }  /* End Namespace `semi' */
 
+
+/* -------------------------------------------------------------------------- */
+
+template <>
+struct std::hash<semi::Range> {
+    size_t
+  operator()( const semi::Range & range ) const noexcept
+  {
+    return range.hash();
+  }
+};
+
 /* -------------------------------------------------------------------------- *
  *
  *
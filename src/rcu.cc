@@ -0,0 +1,170 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>
+
+#include "rcu.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+ConcurrentCatalog::Snapshot::Snapshot( Snapshot && other ) noexcept
+  : slot( other.slot ), catalog( other.catalog )
+{
+  other.slot    = nullptr;
+  other.catalog = nullptr;
+}
+
+
+ConcurrentCatalog::Snapshot::~Snapshot()
+{
+  if ( this->slot != nullptr )
+    {
+      this->slot->store( 0, std::memory_order_release );
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+ConcurrentCatalog::ConcurrentCatalog( VersionCatalog catalog )
+  : current( new VersionCatalog( std::move( catalog ) ) )
+  , slots( std::make_unique<Slot[]>( slotCount ) )
+{}
+
+
+ConcurrentCatalog::~ConcurrentCatalog()
+{
+  for ( const Retired & r : this->retiredList )
+    {
+      delete r.catalog;
+    }
+  delete this->current.load();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  ConcurrentCatalog::Snapshot
+ConcurrentCatalog::snapshot() const
+{
+  /* Start from a slot picked by thread so that readers rarely collide. */
+  const size_t start =
+    std::hash<std::thread::id>()( std::this_thread::get_id() ) % slotCount;
+  for ( size_t n = 0; ; ++n )
+    {
+      std::atomic<uint64_t> & slot  = this->slots[( start + n ) % slotCount]
+                                        .epoch;
+      uint64_t                idle  = 0;
+      const uint64_t          epoch = this->epoch.load();
+      if ( ( slot.load( std::memory_order_relaxed ) == 0 ) &&
+           slot.compare_exchange_strong( idle, epoch )
+         )
+        {
+          /* Claiming the slot is ordered before loading the catalog, so a
+           * writer which retires it after this load will see the slot. */
+          return Snapshot( & slot, this->current.load() );
+        }
+      if ( ( n + 1 ) % slotCount == 0 )
+        {
+          std::this_thread::yield();
+        }
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  void
+ConcurrentCatalog::insert( SemVer version )
+{
+  std::lock_guard lock( this->writer );
+  auto next = std::make_unique<VersionCatalog>( * this->current.load() );
+  next->insert( std::move( version ) );
+  this->publish( std::move( next ) );
+}
+
+
+  void
+ConcurrentCatalog::insert( std::vector<SemVer> versions )
+{
+  std::lock_guard lock( this->writer );
+  auto next = std::make_unique<VersionCatalog>( * this->current.load() );
+  next->insert( std::move( versions ) );
+  this->publish( std::move( next ) );
+}
+
+
+  void
+ConcurrentCatalog::publish( std::unique_ptr<const VersionCatalog> next )
+{
+  const VersionCatalog * old = this->current.exchange( next.release() );
+  /* Snapshots pinned at this epoch or later may only see the new catalog. */
+  const uint64_t epoch = this->epoch.fetch_add( 1 ) + 1;
+  this->retiredList.push_back( Retired { old, epoch } );
+  this->reclaimLocked();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  size_t
+ConcurrentCatalog::retired() const
+{
+  std::lock_guard lock( this->writer );
+  return this->retiredList.size();
+}
+
+
+  void
+ConcurrentCatalog::reclaim()
+{
+  std::lock_guard lock( this->writer );
+  this->reclaimLocked();
+}
+
+
+  void
+ConcurrentCatalog::reclaimLocked()
+{
+  uint64_t oldest = std::numeric_limits<uint64_t>::max();
+  for ( size_t i = 0; i < slotCount; ++i )
+    {
+      const uint64_t pinned = this->slots[i].epoch.load();
+      if ( pinned != 0 )
+        {
+          oldest = std::min( oldest, pinned );
+        }
+    }
+  auto freed = std::remove_if( this->retiredList.begin()
+                             , this->retiredList.end()
+                             , [&]( const Retired & r )
+                               {
+                                 if ( r.epoch <= oldest )
+                                   {
+                                     delete r.catalog;
+                                     return true;
+                                   }
+                                 return false;
+                               }
+                             );
+  this->retiredList.erase( freed, this->retiredList.end() );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
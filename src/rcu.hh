@@ -0,0 +1,142 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "catalog.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * A version catalog which many threads can query while others add versions,
+ * in the style of read-copy-update.
+ *
+ * Readers take a `Snapshot', an immutable catalog which stays valid for as
+ * long as the snapshot is held, without taking any lock: a snapshot claims a
+ * reader slot with a single compare-and-swap, recording the epoch it began
+ * in, and releases it with a store.
+ * Writers are serialized; each copies the current catalog, adds its
+ * versions, and publishes the copy with an atomic exchange.
+ * Replaced catalogs are retired, and freed once no reader slot holds an epoch
+ * from before they were replaced.
+ *
+ * If every reader slot is held, taking a snapshot spins until one is freed.
+ */
+struct ConcurrentCatalog {
+
+/* -------------------------------------------------------------------------- */
+
+    /** The maximum number of snapshots held at once without waiting. */
+    static constexpr size_t slotCount = 128;
+
+    /** A pinned, immutable catalog. */
+    struct Snapshot {
+
+      Snapshot( const Snapshot & ) = delete;
+      Snapshot( Snapshot && other ) noexcept;
+      ~Snapshot();
+
+      Snapshot & operator=( const Snapshot & ) = delete;
+      Snapshot & operator=( Snapshot && ) = delete;
+
+      const VersionCatalog & operator*()  const { return * this->catalog; }
+      const VersionCatalog * operator->() const { return this->catalog; }
+
+      private:
+
+        friend struct ConcurrentCatalog;
+
+        Snapshot( std::atomic<uint64_t> * slot
+                , const VersionCatalog  * catalog
+                )
+          : slot( slot ), catalog( catalog )
+        {}
+
+        std::atomic<uint64_t> * slot;
+        const VersionCatalog  * catalog;
+
+    };  /* End struct `Snapshot' */
+
+
+/* -------------------------------------------------------------------------- */
+
+    explicit ConcurrentCatalog( VersionCatalog catalog = {} );
+    ~ConcurrentCatalog();
+
+    ConcurrentCatalog( const ConcurrentCatalog & ) = delete;
+    ConcurrentCatalog & operator=( const ConcurrentCatalog & ) = delete;
+
+    /** Pin the current catalog. */
+    Snapshot snapshot() const;
+
+    /** Publish a catalog with `version' added. */
+    void insert( SemVer version );
+
+    /** Publish a catalog with all of `versions' added at once. */
+    void insert( std::vector<SemVer> versions );
+
+    /** The number of retired catalogs which have not been freed yet. */
+    size_t retired() const;
+
+    /** Free retired catalogs which no snapshot can still refer to. */
+    void reclaim();
+
+
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    struct alignas( 64 ) Slot {
+      /** The epoch a snapshot was taken in, or 0 if the slot is free. */
+      std::atomic<uint64_t> epoch { 0 };
+    };
+
+    struct Retired {
+      const VersionCatalog * catalog;
+      /** The first epoch in which no new snapshot can pin `catalog'. */
+      uint64_t               epoch;
+    };
+
+    std::atomic<const VersionCatalog *> current;
+    std::atomic<uint64_t>               epoch { 1 };
+    mutable std::unique_ptr<Slot[]>     slots;
+
+    /** Serializes writers, and guards `retiredList'. */
+    mutable std::mutex   writer;
+    std::vector<Retired> retiredList;
+
+    /** Swap in `next', retiring the current catalog; `writer' is held. */
+    void publish( std::unique_ptr<const VersionCatalog> next );
+
+    /** Free what can be freed from `retiredList'; `writer' is held. */
+    void reclaimLocked();
+
+
+/* -------------------------------------------------------------------------- */
+
+};  /* End struct `ConcurrentCatalog' */
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,379 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <charconv>
+
+#include "scan.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+    static inline bool
+  isDigit( char c )
+  {
+    return ( '0' <= c ) && ( c <= '9' );
+  }
+
+  /** Matches `\s' in the ECMAScript grammar for narrow characters. */
+    static inline bool
+  isSpace( char c )
+  {
+    return ( c == ' ' ) || ( ( '\t' <= c ) && ( c <= '\r' ) );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+  /**
+   * Scan the run of digits starting at `pos', advancing `pos' past them.
+   * Strict numbers may not have leading zeroes.
+   */
+    static bool
+  scanNumber( std::string_view   s
+            , size_t           & pos
+            , bool               loose
+            , unsigned int     & value
+            )
+  {
+    const size_t start = pos;
+    while ( ( pos < s.size() ) && isDigit( s[pos] ) )
+      {
+        ++pos;
+      }
+
+    if ( ( pos == start ) ||
+         ( ( ! loose ) && ( 1 < ( pos - start ) ) && ( s[start] == '0' ) )
+       )
+      {
+        return false;
+      }
+
+    const auto [end, ec] =
+      std::from_chars( s.data() + start, s.data() + pos, value );
+    return ( ec == std::errc() ) && ( end == ( s.data() + pos ) );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+  /**
+   * Scan dot separated identifiers starting at `pos', stopping at the first
+   * character which is neither an identifier character nor a '.'.
+   * Strict pre-release identifiers which are entirely numeric may not have
+   * leading zeroes.
+   */
+    static bool
+  scanIdentifiers( std::string_view   s
+                 , size_t           & pos
+                 , bool               checkNumeric
+                 )
+  {
+    while ( true )
+      {
+        const size_t start   = pos;
+        bool         numeric = true;
+        while ( ( pos < s.size() ) && isIdentifierChar( s[pos] ) )
+          {
+            numeric = numeric && isDigit( s[pos] );
+            ++pos;
+          }
+
+        if ( pos == start )
+          {
+            return false;
+          }
+
+        if ( checkNumeric && numeric && ( 1 < ( pos - start ) ) &&
+             ( s[start] == '0' )
+           )
+          {
+            return false;
+          }
+
+        if ( ( pos < s.size() ) && ( s[pos] == '.' ) )
+          {
+            ++pos;
+          }
+        else
+          {
+            return true;
+          }
+      }
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    bool
+  scanSemVer( std::string_view version, bool loose, SemVerParts & parts )
+  {
+    const std::string_view s   = version;
+    size_t                 pos = 0;
+
+    /* Prefix: `v?' or `[v=\s]*' */
+    if ( loose )
+      {
+        while ( ( pos < s.size() ) &&
+                ( ( s[pos] == 'v' ) || ( s[pos] == '=' ) || isSpace( s[pos] ) )
+              )
+          {
+            ++pos;
+          }
+      }
+    else if ( ( pos < s.size() ) && ( s[pos] == 'v' ) )
+      {
+        ++pos;
+      }
+
+    /* Main version */
+    if ( ! scanNumber( s, pos, loose, parts.major ) ) { return false; }
+    if ( ( s.size() <= pos ) || ( s[pos] != '.' ) )  { return false; }
+    ++pos;
+    if ( ! scanNumber( s, pos, loose, parts.minor ) ) { return false; }
+    if ( ( s.size() <= pos ) || ( s[pos] != '.' ) )  { return false; }
+    ++pos;
+    const size_t patchStart = pos;
+    if ( ! scanNumber( s, pos, loose, parts.patch ) ) { return false; }
+
+    /* Pre-release */
+    parts.prerelease = {};
+    size_t preStart  = std::string_view::npos;
+    if ( pos < s.size() )
+      {
+        if ( ( ! loose ) && ( s[pos] == '-' ) )
+          {
+            preStart = pos + 1;
+          }
+        else if ( loose && ( s[pos] == '-' ) )
+          {
+            /* `-?' only consumes the hyphen if an identifier follows it,
+             * otherwise the hyphen is itself an identifier. */
+            const bool skip =
+              ( ( pos + 1 ) < s.size() ) && isIdentifierChar( s[pos + 1] );
+            preStart = skip ? ( pos + 1 ) : pos;
+          }
+        else if ( loose && isIdentifierChar( s[pos] ) )
+          {
+            preStart = pos;
+          }
+        else if ( loose && ( s[pos] == '.' ) && ( 1 < ( pos - patchStart ) ) )
+          {
+            /* The only way for the loose pattern to match "1.2.34.x" is by
+             * backtracking into the patch, yielding "1.2.3-4.x". */
+            preStart = pos - 1;
+            const size_t patchEnd = preStart;
+            pos = patchStart;
+            if ( ! scanNumber( s.substr( 0, patchEnd ), pos, loose
+                             , parts.patch
+                             )
+               )
+              {
+                return false;
+              }
+          }
+      }
+
+    if ( preStart != std::string_view::npos )
+      {
+        pos = preStart;
+        if ( ! scanIdentifiers( s, pos, ! loose ) )
+          {
+            return false;
+          }
+        parts.prerelease = s.substr( preStart, pos - preStart );
+      }
+
+    /* Build metadata */
+    parts.build = {};
+    if ( ( pos < s.size() ) && ( s[pos] == '+' ) )
+      {
+        const size_t buildStart = ++pos;
+        if ( ! scanIdentifiers( s, pos, false ) )
+          {
+            return false;
+          }
+        parts.build = s.substr( buildStart, pos - buildStart );
+      }
+
+    return pos == s.size();
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+  /** Split dot separated identifiers, such as a pre-release tag. */
+    std::vector<std::string>
+  splitIdentifiers( std::string_view ids )
+  {
+    std::vector<std::string> rsl;
+    if ( ids.empty() )
+      {
+        return rsl;
+      }
+    rsl.reserve( std::count( ids.begin(), ids.end(), '.' ) + 1 );
+    for ( size_t dot = ids.find( '.' );
+          dot != std::string_view::npos;
+          dot = ids.find( '.' )
+        )
+      {
+        rsl.emplace_back( ids.substr( 0, dot ) );
+        ids.remove_prefix( dot + 1 );
+      }
+    rsl.emplace_back( ids );
+    return rsl;
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    static inline bool
+  isNumeric( std::string_view id )
+  {
+    return ( ! id.empty() ) &&
+           std::all_of( id.begin(), id.end(), isDigit );
+  }
+
+
+    char
+  compareIdentifier( std::string_view a, std::string_view b )
+  {
+    const bool an = isNumeric( a );
+    const bool bn = isNumeric( b );
+    if ( an != bn )
+      {
+        return an ? -1 : 1;
+      }
+    if ( an )
+      {
+        /* Compare by value without converting, loose identifiers may have
+         * leading zeroes and any number of digits. */
+        a.remove_prefix( std::min( a.find_first_not_of( '0' ), a.size() ) );
+        b.remove_prefix( std::min( b.find_first_not_of( '0' ), b.size() ) );
+        if ( a.size() != b.size() )
+          {
+            return ( a.size() < b.size() ) ? -1 : 1;
+          }
+      }
+    const int c = a.compare( b );
+    return ( c < 0 ) ? -1 : ( ( 0 < c ) ? 1 : 0 );
+  }
+
+
+    Identifier
+  decodeIdentifier( std::string_view id )
+  {
+    if ( ! isNumeric( id ) )
+      {
+        return Identifier { 0, false };
+      }
+    std::uint64_t value = 0;
+    const auto [end, ec] =
+      std::from_chars( id.data(), id.data() + id.size(), value );
+    return Identifier { ( ec == std::errc() ) ? value : UINT64_MAX, true };
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    char
+  compareIdentifiers( std::string_view a, std::string_view b )
+  {
+    while ( true )
+      {
+        const size_t da = a.find( '.' );
+        const size_t db = b.find( '.' );
+        const char   c  =
+          compareIdentifier( a.substr( 0, da ), b.substr( 0, db ) );
+        if ( c != 0 )
+          {
+            return c;
+          }
+        if ( ( da == std::string_view::npos ) ||
+             ( db == std::string_view::npos )
+           )
+          {
+            return ( da == db ) ? 0 : ( ( da == std::string_view::npos ) ? -1
+                                                                         : 1 );
+          }
+        a.remove_prefix( da + 1 );
+        b.remove_prefix( db + 1 );
+      }
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    char
+  compareIdentifierLists( std::string_view a, std::string_view b )
+  {
+    if ( a.empty() || b.empty() )
+      {
+        return ( a.empty() == b.empty() ) ? 0 : ( a.empty() ? 1 : -1 );
+      }
+    return compareIdentifiers( a, b );
+  }
+
+
+    char
+  compareIdentifierLists( std::string_view                 a
+                        , const std::vector<std::string> & b
+                        )
+  {
+    if ( a.empty() || b.empty() )
+      {
+        return ( a.empty() == b.empty() ) ? 0 : ( a.empty() ? 1 : -1 );
+      }
+    for ( auto j = b.cbegin(); j != b.cend(); ++j )
+      {
+        const size_t dot = a.find( '.' );
+        const char   c   = compareIdentifier( a.substr( 0, dot ), * j );
+        if ( c != 0 )
+          {
+            return c;
+          }
+        if ( dot == std::string_view::npos )
+          {
+            return ( ( j + 1 ) == b.cend() ) ? 0 : -1;
+          }
+        a.remove_prefix( dot + 1 );
+      }
+    return 1;
+  }
+
+
+    char
+  compareIdentifierLists( const std::vector<std::string> & a
+                        , const std::vector<std::string> & b
+                        )
+  {
+    if ( a.empty() || b.empty() )
+      {
+        return ( a.empty() == b.empty() ) ? 0 : ( a.empty() ? 1 : -1 );
+      }
+    const size_t len = std::min( a.size(), b.size() );
+    for ( size_t i = 0; i < len; i++ )
+      {
+        const char c = compareIdentifier( a[i], b[i] );
+        if ( c != 0 )
+          {
+            return c;
+          }
+      }
+    return ( a.size() < b.size() ) ? -1 : ( ( b.size() < a.size() ) ? 1 : 0 );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
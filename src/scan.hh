@@ -0,0 +1,141 @@
+/* ========================================================================== *
+ *
+ * Hand written scanners for version strings.
+ * These implement exactly the grammars described by `re::FULL' and
+ * `re::LOOSE' in `regexes.hh', but in a single pass without allocating.
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * The parts of a version string as they were found by `scanSemVer'.
+ * The `prerelease' and `build' members are views into the scanned string,
+ * excluding their leading '-' and '+' characters, and are empty if the
+ * version string did not have those parts.
+ */
+struct SemVerParts {
+  unsigned int     major;
+  unsigned int     minor;
+  unsigned int     patch;
+  std::string_view prerelease;
+  std::string_view build;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+/** Characters which may appear in pre-release and build identifiers. */
+  constexpr bool
+isIdentifierChar( char c )
+{
+  return ( ( '0' <= c ) && ( c <= '9' ) ) ||
+         ( ( 'a' <= c ) && ( c <= 'z' ) ) ||
+         ( ( 'A' <= c ) && ( c <= 'Z' ) ) ||
+         ( c == '-' );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Scan a version string, filling `parts' on success.
+ * Returns `false' if `version' does not match `re::FULL', or `re::LOOSE' if
+ * `loose' is set, or if a numeric part does not fit in an `unsigned int'.
+ */
+bool scanSemVer( std::string_view version, bool loose, SemVerParts & parts );
+
+
+/* -------------------------------------------------------------------------- */
+
+/** Split dot separated identifiers, such as a pre-release tag. */
+std::vector<std::string> splitIdentifiers( std::string_view ids );
+
+
+/**
+ * Order two pre-release or build identifiers, returning a negative number,
+ * zero, or a positive number.
+ * Numeric identifiers order by value and before alphanumeric identifiers,
+ * which order lexically; so "alpha.9" is before "alpha.10".
+ */
+char compareIdentifier( std::string_view a, std::string_view b );
+
+
+/**
+ * A pre-release identifier decoded once for ordering.
+ * Numeric identifiers carry their value, saturated at `UINT64_MAX'.
+ */
+struct Identifier {
+  std::uint64_t value;
+  bool          numeric;
+};
+
+Identifier decodeIdentifier( std::string_view id );
+
+/**
+ * Order two identifiers by their decoded forms, consulting their texts only
+ * if both are alphanumeric or both saturated their numeric values.
+ */
+  inline char
+compareIdentifier( const Identifier & a, std::string_view as
+                 , const Identifier & b, std::string_view bs
+                 )
+{
+  if ( a.numeric && b.numeric && ( a.value != b.value ) )
+    {
+      return ( a.value < b.value ) ? -1 : 1;
+    }
+  if ( a.numeric != b.numeric )
+    {
+      return a.numeric ? -1 : 1;
+    }
+  if ( a.numeric && ( a.value != UINT64_MAX ) )
+    {
+      return 0;
+    }
+  return compareIdentifier( as, bs );
+}
+
+/**
+ * Order two non-empty lists of dot separated identifiers, such as the
+ * `prerelease' views of `SemVerParts', identifier by identifier.
+ * A list which is a prefix of the other is ordered first.
+ */
+char compareIdentifiers( std::string_view a, std::string_view b );
+
+/**
+ * Order two possibly empty identifier lists, where an empty list orders after
+ * any non-empty one the way a release orders after its pre-releases.
+ * Lists are either dot separated strings or vectors of identifiers.
+ */
+char compareIdentifierLists( std::string_view a, std::string_view b );
+
+char compareIdentifierLists( std::string_view                 a
+                           , const std::vector<std::string> & b
+                           );
+
+char compareIdentifierLists( const std::vector<std::string> & a
+                           , const std::vector<std::string> & b
+                           );
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
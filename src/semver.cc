@@ -4,11 +4,13 @@
  *
  * -------------------------------------------------------------------------- */
 
-#include <sstream>
 #include <algorithm>
+#include <cstdio>
+#include <stdexcept>
 
 #include "semver.hh"
-#include "regexes.hh"
+#include "scan.hh"
+#include "view.hh"
 
 namespace semi {
 
@@ -48,81 +50,25 @@ namespace semi {
     this->loose             = loose;
     this->rtl               = rtl;
 
-    const std::regex pattern(
-      loose ? re::LOOSE : re::FULL, std::regex::ECMAScript
-    );
-    std::smatch match;
-
-    std::string _version( version );
-
-    if ( std::regex_match( _version, match, pattern ) )
-      {
-        this->raw = version;
-        if ( match[1].matched )
-          {
-            this->major = std::stol( match[1] );
-          }
-        else
-          {
-            this->major = std::nullopt;
-          }
-
-        if ( match[2].matched )
-          {
-            this->minor = std::stol( match[2] );
-          }
-        else
-          {
-            this->minor = std::nullopt;
-          }
-
-        if ( match[3].matched )
-          {
-            this->patch = std::stol( match[3] );
-          }
-        else
-          {
-            this->patch = std::nullopt;
-          }
-
-        if ( match[4].matched )
-          {
-            std::istringstream iss( match[4] );
-            std::string part;
-            auto itt = std::back_inserter( this->prerelease );
-            while ( std::getline( iss, part, '.' ) )
-              {
-                *itt++ = part;
-              }
-          }
-        else
-          {
-            this->prerelease = {};
-          }
-
-        if ( match[5].matched )
-          {
-            std::istringstream iss( match[5] );
-            std::string part;
-            auto itt = std::back_inserter( this->build );
-            while ( std::getline( iss, part, '.' ) )
-              {
-                *itt++ = part;
-              }
-          }
-        else
-          {
-            this->build = {};
-          }
-      }
-    else
+    SemVerParts parts;
+    if ( ! scanSemVer( version, loose, parts ) )
       {
         throw std::invalid_argument(
-          "Invalid semantic version: '" + _version + "'"
+          "Invalid semantic version: '" + std::string( version ) + "'"
         );
       }
 
-    this->version = "";
+    this->raw        = version;
+    this->major      = parts.major;
+    this->minor      = parts.minor;
+    this->patch      = parts.patch;
+    this->prerelease = splitIdentifiers( parts.prerelease );
+    this->build      = splitIdentifiers( parts.build );
+    this->lazy       = false;
+    this->preBegin   = 0;
+    this->preEnd     = 0;
+    this->buildBegin = 0;
+
     this->format();
   }
 
@@ -144,6 +90,10 @@ namespace semi {
     , includePrerelease( ! prerelease.empty() )
     , loose( false )
     , rtl( false )
+    , lazy( false )
+    , preBegin( 0 )
+    , preEnd( 0 )
+    , buildBegin( 0 )
   {
     /* Set `this->version' */
     this->format();
@@ -151,48 +101,145 @@ namespace semi {
   }
 
 
+/* -------------------------------------------------------------------------- */
+
+    SemVer
+  SemVer::parseLazy( std::string_view version
+                   , bool             includePrerelease
+                   , bool             loose
+                   )
+  {
+    SemVerParts parts;
+    if ( ! scanSemVer( version, loose, parts ) )
+      {
+        throw std::invalid_argument(
+          "Invalid semantic version: '" + std::string( version ) + "'"
+        );
+      }
+
+    return SemVer( parts, version, includePrerelease, loose );
+  }
+
+
+  SemVer::SemVer( const SemVerParts & parts
+                , std::string_view    version
+                , bool                includePrerelease
+                , bool                loose
+                )
+    : version()
+    , raw( version )
+    , major( parts.major )
+    , minor( parts.minor )
+    , patch( parts.patch )
+    , prerelease()
+    , build()
+    , key( makeVersionKey( parts.major, parts.minor, parts.patch
+                         , ! parts.prerelease.empty()
+                         )
+         )
+    , includePrerelease( includePrerelease )
+    , loose( loose )
+    , rtl( false )
+    , lazy( true )
+    , preBegin( 0 )
+    , preEnd( 0 )
+    , buildBegin( version.size() )
+  {
+    if ( ! parts.prerelease.empty() )
+      {
+        this->preBegin = parts.prerelease.data() - version.data();
+        this->preEnd   = this->preBegin + parts.prerelease.size();
+      }
+    if ( ! parts.build.empty() )
+      {
+        this->buildBegin = parts.build.data() - version.data();
+      }
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    std::string_view
+  SemVer::prereleaseText() const
+  {
+    if ( this->lazy )
+      {
+        return std::string_view( this->raw ).substr(
+          this->preBegin, this->preEnd - this->preBegin
+        );
+      }
+    /* The `version' string is rendered as "<MAIN>-<PRERELEASE>". */
+    const size_t dash = this->version.find( '-' );
+    return ( dash == std::string::npos )
+           ? std::string_view()
+           : std::string_view( this->version ).substr( dash + 1 );
+  }
+
+
+    const std::vector<std::string> &
+  SemVer::getPrerelease()
+  {
+    if ( this->lazy )
+      {
+        this->format();
+      }
+    return this->prerelease;
+  }
+
+
+    const std::vector<std::string> &
+  SemVer::getBuild()
+  {
+    if ( this->lazy )
+      {
+        this->format();
+      }
+    return this->build;
+  }
+
+
 /* -------------------------------------------------------------------------- */
 
   /**
    * Convert a semantic version parts to a string, updating the `version'
-   * member on this record.
+   * and `key' members on this record.
    * Build information is always omitted.
+   * Lazily parsed versions have their identifiers split first.
    */
     const std::string &
   SemVer::format()
   {
-    char buf[256];
-    if ( this->prerelease.empty() )
+    if ( this->lazy )
       {
-        std::snprintf(
-          buf, 256, "%s.%s.%s",
-          vptos( this->major ).c_str(),
-          vptos( this->minor ).c_str(),
-          vptos( this->patch ).c_str()
-        );
+        const std::string_view raw( this->raw );
+        this->prerelease =
+          splitIdentifiers( raw.substr( this->preBegin
+                                      , this->preEnd - this->preBegin
+                                      )
+                          );
+        this->build = splitIdentifiers( raw.substr( this->buildBegin ) );
+        this->lazy  = false;
       }
-    else
+
+    this->version = vptos( this->major ) + "." + vptos( this->minor ) + "." +
+                    vptos( this->patch );
+    /* Join prerelease parts with dots. */
+    for ( auto i = this->prerelease.cbegin(); i != this->prerelease.cend(); )
       {
-        std::stringstream ss;
-        /* Join prerelease parts with dots. */
-        for (
-          auto i = this->prerelease.cbegin();
-          i != this->prerelease.cend();
-          ++i
-        )
-        {
-          ss << "." << *i;
-        }
-        std::snprintf(
-          buf, 256, "%s.%s.%s-%s",
-          vptos( this->major ).c_str(),
-          vptos( this->minor ).c_str(),
-          vptos( this->patch ).c_str(),
-          ss.str().c_str()
-        );
+        this->version += ( i == this->prerelease.cbegin() ) ? "-" : ".";
+        this->version += *i++;
       }
-
-    this->version = buf;
+    this->prereleaseIds.clear();
+    this->prereleaseIds.reserve( this->prerelease.size() );
+    for ( const std::string & id : this->prerelease )
+      {
+        this->prereleaseIds.push_back( decodeIdentifier( id ) );
+      }
+    this->key = makeVersionKey( this->major.value_or( 0 )
+                              , this->minor.value_or( 0 )
+                              , this->patch.value_or( 0 )
+                              , ! this->prerelease.empty()
+                              );
     return this->version;
   }
 
@@ -207,22 +254,48 @@ namespace semi {
     std::string
   SemVer::toString() const
   {
+    if ( this->lazy )
+      {
+        std::string rsl = vptos( this->major ) + "." + vptos( this->minor ) +
+                          "." + vptos( this->patch );
+        if ( this->preBegin != this->preEnd )
+          {
+            rsl += "-";
+            rsl += this->prereleaseText();
+          }
+        return rsl;
+      }
     return this->version;
   }
 
 
+/* -------------------------------------------------------------------------- */
+
+  /** Whether a version has all of its main version parts set. */
+    static inline bool
+  hasMain( const SemVer & v )
+  {
+    return v.major.has_value() && v.minor.has_value() && v.patch.has_value();
+  }
+
+
 /* -------------------------------------------------------------------------- */
 
     char
   SemVer::compare( const SemVer & other ) const
   {
-    const SemVer o( other.version,
-                    this->includePrerelease,
-                    this->loose,
-                    this->rtl
-                  );
+    if ( hasMain( *this ) && hasMain( other ) )
+      {
+        const char c = compareVersionKeys( this->key, other.key );
+        /* Releases with equal keys are equal, pre-releases break ties. */
+        if ( ( c != 0 ) || ( ( this->key & 1 ) != 0 ) )
+          {
+            return c;
+          }
+        return this->comparePre( other );
+      }
 
-    if ( this->version == o.version )
+    if ( this->version == other.version )
       {
         return 0;
       }
@@ -243,38 +316,39 @@ namespace semi {
     char
   SemVer::compareMain( const SemVer & other ) const
   {
-    const SemVer o( other.version,
-                    this->includePrerelease,
-                    this->loose,
-                    this->rtl
-                  );
+    if ( hasMain( *this ) && hasMain( other ) )
+      {
+        return compareVersionKeys( this->key >> 1, other.key >> 1 );
+      }
 
-    if ( ! ( this->major.has_value() && o.major.has_value() ) )
+    /* Partial versions only compare the parts both of them have. */
+    if ( ! ( this->major.has_value() && other.major.has_value() ) )
       {
         return 0;
       }
 
-    if ( this->major.value() != o.major.value() )
+    if ( this->major.value() != other.major.value() )
       {
-        return this->major.value() - o.major.value();
+        return ( this->major.value() < other.major.value() ) ? -1 : 1;
       }
 
-    if ( ! ( this->minor.has_value() && o.minor.has_value() ) )
+    if ( ! ( this->minor.has_value() && other.minor.has_value() ) )
       {
         return 0;
       }
 
-    if ( this->minor.value() != o.minor.value() )
+    if ( this->minor.value() != other.minor.value() )
       {
-        return this->minor.value() - o.minor.value();
+        return ( this->minor.value() < other.minor.value() ) ? -1 : 1;
       }
 
-    if ( ! ( this->patch.has_value() && o.patch.has_value() ) )
+    if ( ! ( this->patch.has_value() && other.patch.has_value() ) )
       {
         return 0;
       }
 
-    return this->patch.value() - o.patch.value();
+    return ( this->patch.value() < other.patch.value() ) ? -1 :
+           ( ( other.patch.value() < this->patch.value() ) ? 1 : 0 );
   }
 
 
@@ -283,48 +357,47 @@ namespace semi {
     char
   SemVer::comparePre( const SemVer & other ) const
   {
-    const SemVer o( other.version,
-                    this->includePrerelease,
-                    this->loose,
-                    this->rtl
-                  );
-
-    if ( this->prerelease.empty() && o.prerelease.empty() )
+    if ( this->lazy || other.lazy )
       {
-        return 0;
+        return compareIdentifierLists( this->prereleaseText()
+                                     , other.prereleaseText()
+                                     );
       }
 
     /**
      * Having a prerelease identifier implies being "younger".
      * So, if we don't have one and the other does, we are older.
      */
-    if ( this->prerelease.empty() )
-      {
-        return 1;
-      }
-
-    if ( o.prerelease.empty() )
+    if ( this->prerelease.empty() || other.prerelease.empty() )
       {
-        return -1;
+        return ( this->prerelease.empty() == other.prerelease.empty() )
+               ? 0
+               : ( this->prerelease.empty() ? 1 : -1 );
       }
 
     const size_t la  = this->prerelease.size();
-    const size_t lo  = o.prerelease.size();
+    const size_t lo  = other.prerelease.size();
     const size_t len = std::min( la, lo );
 
+    /* Decoded identifiers are stale if `prerelease' was modified without
+     * calling `format'; compare the strings instead. */
+    const bool decoded = ( this->prereleaseIds.size() == la ) &&
+                         ( other.prereleaseIds.size() == lo );
+
     for ( size_t i = 0; i < len; i++ )
       {
-        if ( this->prerelease[i] < o.prerelease[i] )
-          {
-            return -1;
-          }
-        if ( o.prerelease[i] < this->prerelease[i] )
+        const char c = decoded
+          ? compareIdentifier( this->prereleaseIds[i], this->prerelease[i]
+                             , other.prereleaseIds[i], other.prerelease[i]
+                             )
+          : compareIdentifier( this->prerelease[i], other.prerelease[i] );
+        if ( c != 0 )
           {
-            return 1;
+            return c;
           }
       }
 
-    return la - lo;
+    return ( la < lo ) ? -1 : ( ( lo < la ) ? 1 : 0 );
   }
 
 
@@ -333,44 +406,76 @@ namespace semi {
     char
   SemVer::compareBuild( const SemVer & other ) const
   {
-    const SemVer o( other.version,
-                    this->includePrerelease,
-                    this->loose,
-                    this->rtl
-                  );
-
-    if ( this->build.empty() && o.build.empty() )
+    /* Scan deferred build metadata rather than splitting it. */
+    if ( this->lazy )
       {
-        return 0;
+        return SemVerView( this->raw, this->loose ).compareBuild( other );
       }
-
-    if ( this->build.empty() )
+    if ( other.lazy )
       {
-        return 1;
+        return -SemVerView( other.raw, other.loose ).compareBuild( * this );
       }
+    return compareIdentifierLists( this->build, other.build );
+  }
 
-    if ( o.build.empty() )
-      {
-        return -1;
-      }
 
-    const size_t la  = this->build.size();
-    const size_t lo  = o.build.size();
-    const size_t len = std::min( la, lo );
+    bool
+  SemVer::operator==( const SemVer & other ) const
+  {
+    return ( this->major == other.major ) && ( this->minor == other.minor ) &&
+           ( this->patch == other.patch ) &&
+           ( this->comparePre( other ) == 0 );
+  }
 
-    for ( size_t i = 0; i < len; i++ )
+
+/* -------------------------------------------------------------------------- */
+
+    uint64_t
+  hashVersion( VersionKey key, std::string_view prerelease )
+  {
+    uint64_t rsl = hashCombine( static_cast<uint64_t>( key )
+                              , static_cast<uint64_t>( key >> 64 )
+                              );
+    for ( std::string_view id : Identifiers { prerelease } )
       {
-        if ( this->build[i] < o.build[i] )
+        /* Equal numeric values are equal identifiers.  Saturated values are
+         * hashed by their digits, which loose versions may pad with zeroes. */
+        const Identifier i = decodeIdentifier( id );
+        if ( i.numeric && ( i.value != UINT64_MAX ) )
           {
-            return -1;
+            rsl = hashCombine( rsl, i.value );
+            continue;
           }
-        if ( o.build[i] < this->build[i] )
+        if ( i.numeric )
           {
-            return 1;
+            id.remove_prefix( std::min( id.find_first_not_of( '0' )
+                                      , id.size()
+                                      )
+                            );
           }
+        rsl = hashCombine( rsl, std::hash<std::string_view>()( id ) );
       }
+    return rsl;
+  }
 
-    return la - lo;
+
+    uint64_t
+  SemVer::hash() const
+  {
+    const std::string_view pre = this->prereleaseText();
+    const uint64_t         rsl = hashVersion(
+      makeVersionKey( this->major.value_or( 0 ), this->minor.value_or( 0 )
+                    , this->patch.value_or( 0 ), ! pre.empty()
+                    )
+    , pre
+    );
+    if ( hasMain( * this ) )
+      {
+        return rsl;
+      }
+    return hashCombine( rsl, ( this->major.has_value() ? 1 : 0 ) |
+                             ( this->minor.has_value() ? 2 : 0 )
+                      );
   }
 
 
@@ -6,14 +6,74 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 
+#include "scan.hh"
+
 /* -------------------------------------------------------------------------- */
 
 namespace semi {
 
+/* -------------------------------------------------------------------------- */
+
+/**
+ * A version's main tuple packed into a single integer, ordered such that
+ * comparing keys orders versions by major, minor, and patch.
+ * The lowest bit is set for versions without a pre-release tag, so that a
+ * release orders after all pre-releases of the same tuple; two versions with
+ * equal keys only need their pre-release identifiers compared if that bit
+ * is clear.
+ *   key = major << 65 | minor << 33 | patch << 1 | prerelease.empty()
+ */
+__extension__ typedef unsigned __int128 VersionKey;
+
+  constexpr VersionKey
+makeVersionKey( unsigned int major
+              , unsigned int minor
+              , unsigned int patch
+              , bool         isPrerelease
+              )
+{
+  return ( static_cast<VersionKey>( major ) << 65 ) |
+         ( static_cast<VersionKey>( minor ) << 33 ) |
+         ( static_cast<VersionKey>( patch ) << 1 )  |
+         ( isPrerelease ? 0 : 1 );
+}
+
+  constexpr char
+compareVersionKeys( VersionKey a, VersionKey b )
+{
+  return ( a < b ) ? -1 : ( ( b < a ) ? 1 : 0 );
+}
+
+
+/** Mix `value' into the running hash `seed', with splitmix64's finalizer. */
+  constexpr uint64_t
+hashCombine( uint64_t seed, uint64_t value )
+{
+  uint64_t x = seed ^ ( value + 0x9e3779b97f4a7c15ULL + ( seed << 6 ) +
+                        ( seed >> 2 )
+                      );
+  x = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+  x = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebULL;
+  return x ^ ( x >> 31 );
+}
+
+/**
+ * Hash a version by its key and dot separated pre-release identifiers, such
+ * that versions equal under `SemVer::compare' hash equally.
+ * Numeric identifiers are hashed by value and others by text, without
+ * allocating.
+ */
+uint64_t hashVersion( VersionKey key, std::string_view prerelease );
+
+
 /* -------------------------------------------------------------------------- */
 
 struct SemVer {
@@ -30,6 +90,19 @@ struct SemVer {
     std::vector<std::string>    prerelease;
     std::vector<std::string>    build;
 
+    /**
+     * Ordering key derived from the parts above by `format'.
+     * Only meaningful if `major', `minor', and `patch' are all set.
+     */
+    VersionKey key;
+
+    /**
+     * The `prerelease' identifiers decoded for ordering by `format', so that
+     * `comparePre' can compare numeric identifiers as integers.
+     * They are ignored if their count no longer matches `prerelease'.
+     */
+    std::vector<Identifier> prereleaseIds;
+
     /**
      * Normally "max version" ranges will prefer lower versions if higher
      * versioned candidates are tagged with a pre-release suffix.
@@ -52,6 +125,13 @@ struct SemVer {
      */
     bool rtl;
 
+    /**
+     * Set on versions returned by `parseLazy' until their `version',
+     * `prerelease', and `build' members are filled by `format'.
+     * Until then only the main version parts and `key' are decoded.
+     */
+    bool lazy;
+
 
 /* -------------------------------------------------------------------------- */
 
@@ -76,6 +156,29 @@ struct SemVer {
       std::vector<std::string>    build      = {}
     );
 
+    /**
+     * Construct a version from a string, deferring the splitting of its
+     * pre-release and build identifiers until they are asked for.
+     * Comparisons read them directly from `raw' in the meantime.
+     */
+      static SemVer
+    parseLazy( std::string_view version
+             , bool             includePrerelease = false
+             , bool             loose             = false
+             );
+
+
+/* -------------------------------------------------------------------------- */
+
+    /* Accessors */
+
+    /** Dot separated pre-release identifiers, or an empty string. */
+    std::string_view prereleaseText() const;
+
+    /** Fill the members deferred by `parseLazy' if necessary. */
+    const std::vector<std::string> & getPrerelease();
+    const std::vector<std::string> & getBuild();
+
 
 /* -------------------------------------------------------------------------- */
 
@@ -90,11 +193,26 @@ struct SemVer {
 
     /* Comparators */
 
+    /**
+     * These return a negative number, zero, or a positive number if this
+     * version is ordered before, equal to, or after `other'.
+     * Build metadata is only considered by `compareBuild'.
+     */
     char compare(      const SemVer & other ) const;
     char compareMain(  const SemVer & other ) const;
     char comparePre(   const SemVer & other ) const;
     char compareBuild( const SemVer & other ) const;
 
+    /**
+     * Whether versions are equal under `compare', ignoring build metadata.
+     * Versions missing main parts are only equal to versions missing the
+     * same parts, unlike under `compare', so that this is an equivalence.
+     */
+    bool operator==( const SemVer & other ) const;
+
+    /** A hash consistent with `operator==', as `hashVersion' computes. */
+    uint64_t hash() const;
+
 
 /* -------------------------------------------------------------------------- */
 
@@ -104,15 +222,83 @@ struct SemVer {
     //SemVer inc( const std::string release, const std::string identifier );
 
 
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    /** Offsets of the pre-release and build identifiers in `raw'. */
+    std::uint32_t preBegin;
+    std::uint32_t preEnd;
+    std::uint32_t buildBegin;
+
+    /** Used by `parseLazy' to skip splitting identifiers and `format'. */
+    SemVer( const SemVerParts & parts
+          , std::string_view    version
+          , bool                includePrerelease
+          , bool                loose
+          );
+
+
 /* -------------------------------------------------------------------------- */
 
 };  /* End struct `SemVer' */
 
 
+/** Whether `a' is ordered before `b' by `SemVer::compare', for sorting. */
+  inline bool
+lessVersion( const SemVer & a, const SemVer & b )
+{
+  return a.compare( b ) < 0;
+}
+
+
+/** The pre-release tag of a version, or the tag itself, for `compareKeyed'. */
+  inline std::string_view
+prereleaseTag( std::string_view tag )
+{
+  return tag;
+}
+
+  inline std::string_view
+prereleaseTag( const SemVer & version )
+{
+  return version.prereleaseText();
+}
+
+
+/**
+ * Order versions by their keys and pre-release tags, as `SemVer::compare'
+ * does, where each tag is given as a string or by its version.
+ * Tags are only read for pre-releases of the same main version.
+ */
+template <typename A, typename B>
+  inline char
+compareKeyed( VersionKey a, const A & aTag, VersionKey b, const B & bTag )
+{
+  if ( ( a != b ) || ( ( a & 1 ) != 0 ) )
+    {
+      return compareVersionKeys( a, b );
+    }
+  return compareIdentifierLists( prereleaseTag( aTag ), prereleaseTag( bTag ) );
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 }  /* End Namespace `semi' */
 
+
+/* -------------------------------------------------------------------------- */
+
+template <>
+struct std::hash<semi::SemVer> {
+    size_t
+  operator()( const semi::SemVer & version ) const noexcept
+  {
+    return version.hash();
+  }
+};
+
 /* -------------------------------------------------------------------------- *
  *
  *
@@ -0,0 +1,281 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "sort.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/** A version's key and its position in the input. */
+struct Keyed {
+  VersionKey key;
+  size_t     index;
+};
+
+
+/** Bits per radix digit, and the digits covering a key's 97 bits. */
+static constexpr unsigned radixBits = 11;
+static constexpr unsigned radixSize = 1u << radixBits;
+static constexpr unsigned keyBits   = 97;
+
+/** How many versions ahead to prefetch while gathering them. */
+static constexpr size_t prefetchDistance = 8;
+
+/** Inputs below this size are sorted on the calling thread. */
+static constexpr size_t parallelFloor = 1 << 16;
+
+
+  static unsigned
+digitOf( VersionKey key, unsigned shift )
+{
+  return static_cast<unsigned>( key >> shift ) & ( radixSize - 1 );
+}
+
+
+/** Run `fn( worker, begin, end )' on even slices of [0, n) in parallel. */
+  static void
+runWorkers( size_t                                                n
+          , size_t                                                workers
+          , const std::function<void( size_t, size_t, size_t )> & fn
+          )
+{
+  std::vector<std::thread> threads;
+  for ( size_t w = 1; w < workers; ++w )
+    {
+      threads.emplace_back( fn, w, ( n * w ) / workers
+                          , ( n * ( w + 1 ) ) / workers
+                          );
+    }
+  fn( 0, 0, n / workers );
+  for ( std::thread & t : threads )
+    {
+      t.join();
+    }
+}
+
+
+/** Order versions of equal keys, which only differ in pre-release or build. */
+  static bool
+lessTie( const SemVer & a, const SemVer & b )
+{
+  if ( ( a.key & 1 ) == 0 )
+    {
+      const char c = a.comparePre( b );
+      if ( c != 0 )
+        {
+          return c < 0;
+        }
+    }
+  return a.compareBuild( b ) < 0;
+}
+
+
+/** Whether versions are equal, including their build metadata. */
+  static bool
+sameVersion( const SemVer & a, const SemVer & b )
+{
+  return ( a.key == b.key ) && ( a.compare( b ) == 0 ) &&
+         ( a.compareBuild( b ) == 0 );
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  void
+sort( std::span<SemVer> versions, unsigned int threads )
+{
+  if ( threads == 0 )
+    {
+      threads = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+  const size_t n       = versions.size();
+  const size_t workers = ( n < parallelFloor ) ? 1 : threads;
+  std::vector<Keyed> keyed( n );
+  std::vector<Keyed> scratch( n );
+
+  runWorkers( n, workers, [&]( size_t, size_t begin, size_t end )
+    {
+      for ( size_t i = begin; i < end; ++i )
+        {
+          keyed[i] = Keyed { versions[i].key, i };
+        }
+    } );
+
+  /* Least significant digit first, with a histogram per worker so that each
+   * can scatter its slice to its own offsets, keeping the sort stable. */
+  using Histogram = std::array<size_t, radixSize>;
+  std::vector<Histogram> counts( workers );
+  for ( unsigned shift = 0; shift < keyBits; shift += radixBits )
+    {
+      runWorkers( n, workers, [&]( size_t w, size_t begin, size_t end )
+        {
+          counts[w].fill( 0 );
+          for ( size_t i = begin; i < end; ++i )
+            {
+              ++counts[w][digitOf( keyed[i].key, shift )];
+            }
+        } );
+
+      /* Skip digits which every key shares, such as high bits of majors. */
+      const unsigned first = digitOf( n == 0 ? 0 : keyed[0].key, shift );
+      size_t         same  = 0;
+      for ( const Histogram & h : counts )
+        {
+          same += h[first];
+        }
+      if ( same == n )
+        {
+          continue;
+        }
+
+      size_t offset = 0;
+      for ( unsigned d = 0; d < radixSize; ++d )
+        {
+          for ( Histogram & h : counts )
+            {
+              const size_t c = h[d];
+              h[d]    = offset;
+              offset += c;
+            }
+        }
+
+      runWorkers( n, workers, [&]( size_t w, size_t begin, size_t end )
+        {
+          Histogram & next = counts[w];
+          for ( size_t i = begin; i < end; ++i )
+            {
+              scratch[next[digitOf( keyed[i].key, shift )]++] = keyed[i];
+            }
+        } );
+      keyed.swap( scratch );
+    }
+
+  /* Widen the slice boundaries to the ends of the runs of equal keys they
+   * are in, so that no run is split between workers.
+   * This is done up front, as workers reorder `keyed' within their runs. */
+  std::vector<size_t> bounds( workers + 1, n );
+  for ( size_t w = 0; w < workers; ++w )
+    {
+      size_t i = ( n * w ) / workers;
+      while ( ( 0 < i ) && ( i < n ) && ( keyed[i].key == keyed[i - 1].key ) )
+        {
+          ++i;
+        }
+      bounds[w] = i;
+    }
+
+  /* Gather versions in key order into uninitialized storage, then order each
+   * run of equal keys there, where its versions are adjacent, recording the
+   * position each index takes its version from. */
+  std::allocator<SemVer> allocator;
+  SemVer * const         sorted = allocator.allocate( n );
+  runWorkers( n, workers, [&]( size_t w, size_t, size_t )
+    {
+      const size_t begin = bounds[w];
+      const size_t end   = bounds[w + 1];
+      for ( size_t i = begin; i < end; ++i )
+        {
+          /* Versions are gathered from all over, so fetch ahead. */
+          if ( i + prefetchDistance < end )
+            {
+              const char * next = reinterpret_cast<const char *>(
+                & versions[keyed[i + prefetchDistance].index]
+              );
+              for ( size_t b = 0; b < sizeof( SemVer ); b += 64 )
+                {
+                  __builtin_prefetch( next + b );
+                }
+            }
+          std::construct_at( sorted + i
+                           , std::move( versions[keyed[i].index] )
+                           );
+          keyed[i].index = i;
+        }
+      for ( size_t i = begin; i < end; )
+        {
+          size_t j = i + 1;
+          while ( ( j < end ) && ( keyed[j].key == keyed[i].key ) )
+            {
+              ++j;
+            }
+          if ( 1 < j - i )
+            {
+              std::stable_sort( keyed.begin() + i, keyed.begin() + j
+                              , [&]( const Keyed & a, const Keyed & b )
+                                {
+                                  return lessTie( sorted[a.index]
+                                                , sorted[b.index]
+                                                );
+                                }
+                              );
+            }
+          i = j;
+        }
+    } );
+
+  /* Only once every version has been moved out of `versions'. */
+  runWorkers( n, workers, [&]( size_t w, size_t, size_t )
+    {
+      const size_t begin = bounds[w];
+      const size_t end   = bounds[w + 1];
+      for ( size_t i = begin; i < end; ++i )
+        {
+          versions[i] = std::move( sorted[keyed[i].index] );
+        }
+      std::destroy( sorted + begin, sorted + end );
+    } );
+  allocator.deallocate( sorted, n );
+}
+
+
+  void
+rsort( std::span<SemVer> versions, unsigned int threads )
+{
+  sort( versions, threads );
+  std::reverse( versions.begin(), versions.end() );
+
+  /* Put runs of equal versions back in their input order. */
+  for ( auto i = versions.begin(); i != versions.end(); )
+    {
+      auto j = i + 1;
+      while ( ( j != versions.end() ) && sameVersion( * i, * j ) )
+        {
+          ++j;
+        }
+      std::reverse( i, j );
+      i = j;
+    }
+}
+
+
+  size_t
+unique( std::span<SemVer> versions )
+{
+  const auto last = std::unique( versions.begin(), versions.end()
+                               , sameVersion
+                               );
+  return last - versions.begin();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,57 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "semver.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Sort versions ascending, in `SemVer::compare' order with ties broken by
+ * `SemVer::compareBuild', as node-semver's `sort' does.
+ *
+ * Versions are radix sorted by their packed `VersionKey', so that only
+ * versions with the same main version and a pre-release, or with build
+ * metadata, are ever compared, in a second pass over those runs.
+ * Large inputs are split across up to `threads' threads, or one per hardware
+ * thread if that is zero.
+ * Versions must have every main version part set.
+ * The sort is stable.
+ */
+void sort( std::span<SemVer> versions, unsigned int threads = 0 );
+
+/**
+ * Sort versions descending, the reverse of `sort', except that equal versions
+ * keep their input order, as they do in node-semver's `rsort'.
+ */
+void rsort( std::span<SemVer> versions, unsigned int threads = 0 );
+
+/**
+ * Drop versions equal to the one before them under `SemVer::compare' and
+ * `SemVer::compareBuild', as `std::unique' does, returning the number of
+ * versions kept at the front of `versions'.
+ * Versions should be sorted first, by `sort' or `rsort'.
+ */
+size_t unique( std::span<SemVer> versions );
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,334 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <utility>
+
+#include "stabbing.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/** An interval bound, ordered by its key before its identifiers. */
+struct Point {
+  VersionKey     key;
+  const SemVer * version;
+};
+
+  static Point
+pointOf( const SemVer & version )
+{
+  return Point { version.key, & version };
+}
+
+
+/** Order a bound against a version, as `SemVer::compare' does. */
+  static char
+compare( const Point & point, const SemVer & version )
+{
+  return compareKeyed( point.key, * point.version, version.key, version );
+}
+
+
+  static bool
+operator<( const Point & a, const Point & b )
+{
+  return compareKeyed( a.key, * a.version, b.key, * b.version ) < 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+struct Stabbed {
+  Point          lower;
+  Point          upper;
+  bool           bounded;
+  RangeIndex::Id id;
+};
+
+
+/** Whether `a' ends before `b', counting no upper bound as the highest. */
+  static bool
+endsBefore( const Stabbed & a, const Stabbed & b )
+{
+  if ( ! b.bounded )
+    {
+      return a.bounded;
+    }
+  return a.bounded && ( a.upper < b.upper );
+}
+
+
+/**
+ * A static priority search tree.
+ * Each node holds the interval with the highest upper bound in its subtree,
+ * and splits the rest by lower bound, so that every lower bound in its right
+ * subtree is at or after `split'.
+ */
+struct SearchTree {
+
+  struct Node {
+    Stabbed interval;
+    Point   split;
+    int32_t left;
+    int32_t right;
+  };
+
+  std::vector<Node> nodes;
+
+  bool empty() const { return this->nodes.empty(); }
+
+    static SearchTree
+  build( std::vector<Stabbed> intervals )
+  {
+    std::sort( intervals.begin(), intervals.end()
+             , []( const Stabbed & a, const Stabbed & b )
+               {
+                 return a.lower < b.lower;
+               }
+             );
+    SearchTree rsl;
+    rsl.nodes.reserve( intervals.size() );
+    rsl.buildNode( intervals, 0, intervals.size() );
+    return rsl;
+  }
+
+  /** Build a subtree of `sorted[lo, hi)', returning its root. */
+    int32_t
+  buildNode( std::vector<Stabbed> & sorted, size_t lo, size_t hi )
+  {
+    if ( lo == hi )
+      {
+        return -1;
+      }
+    /* Move the highest interval to the front, keeping the rest in order. */
+    auto top = std::max_element( sorted.begin() + lo, sorted.begin() + hi
+                               , endsBefore
+                               );
+    std::rotate( sorted.begin() + lo, top, top + 1 );
+
+    const int32_t idx = this->nodes.size();
+    this->nodes.push_back( Node { sorted[lo], {}, -1, -1 } );
+    const size_t mid = ( lo + 1 + hi ) / 2;
+    if ( mid < hi )
+      {
+        this->nodes[idx].split = sorted[mid].lower;
+      }
+    const int32_t left  = this->buildNode( sorted, lo + 1, mid );
+    const int32_t right = this->buildNode( sorted, mid, hi );
+    this->nodes[idx].left  = left;
+    this->nodes[idx].right = right;
+    return idx;
+  }
+
+    void
+  stab( int32_t                       idx
+      , const SemVer                & version
+      , std::vector<RangeIndex::Id> & rsl
+      ) const
+  {
+    while ( idx != -1 )
+      {
+        const Node & node = this->nodes[idx];
+        /* Nothing below ends after `version'. */
+        if ( node.interval.bounded &&
+             ( compare( node.interval.upper, version ) <= 0 )
+           )
+          {
+            return;
+          }
+        if ( compare( node.interval.lower, version ) <= 0 )
+          {
+            rsl.push_back( node.interval.id );
+          }
+        if ( ( node.right != -1 ) && ( compare( node.split, version ) <= 0 ) )
+          {
+            this->stab( node.right, version, rsl );
+          }
+        idx = node.left;
+      }
+  }
+
+};  /* End struct `SearchTree' */
+
+
+/* -------------------------------------------------------------------------- */
+
+struct IntervalForest {
+
+  /** Trees of up to 2^i intervals at level i, or empty ones. */
+  std::vector<SearchTree> levels;
+
+    void
+  insert( std::vector<Stabbed> carry )
+  {
+    for ( size_t i = 0; ; ++i )
+      {
+        if ( i == this->levels.size() )
+          {
+            this->levels.emplace_back();
+          }
+        if ( this->levels[i].empty() &&
+             ( carry.size() <= ( size_t( 1 ) << i ) )
+           )
+          {
+            this->levels[i] = SearchTree::build( std::move( carry ) );
+            return;
+          }
+        for ( const SearchTree::Node & node : this->levels[i].nodes )
+          {
+            carry.push_back( node.interval );
+          }
+        this->levels[i] = SearchTree();
+      }
+  }
+
+    void
+  stab( const SemVer & version, std::vector<RangeIndex::Id> & rsl ) const
+  {
+    for ( const SearchTree & tree : this->levels )
+      {
+        if ( ! tree.empty() )
+          {
+            tree.stab( 0, version, rsl );
+          }
+      }
+  }
+
+};  /* End struct `IntervalForest' */
+
+
+  static std::vector<Stabbed>
+stabbedOf( const std::vector<Interval> & intervals, RangeIndex::Id id )
+{
+  std::vector<Stabbed> rsl;
+  for ( const Interval & i : intervals )
+    {
+      rsl.push_back( Stabbed {
+        pointOf( i.lower )
+      , i.upper.has_value() ? pointOf( * i.upper ) : Point {}
+      , i.upper.has_value()
+      , id
+      } );
+    }
+  return rsl;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+RangeIndex::RangeIndex()
+  : releases( std::make_unique<IntervalForest>() )
+  , all( std::make_unique<IntervalForest>() )
+{}
+
+/* Out of line, where `IntervalForest' is complete. */
+RangeIndex::~RangeIndex() = default;
+
+
+  RangeIndex::Id
+RangeIndex::insert( const Range & range )
+{
+  const Id     id         = this->nextId++;
+  Registered & registered = this->ranges[id];
+  if ( range.includePrerelease )
+    {
+      registered.all = range.compiled.intervals;
+    }
+  else
+    {
+      registered.releases = range.compiled.intervals;
+      registered.all      = range.compiled.prerelease;
+    }
+  this->releases->insert( stabbedOf( registered.releases, id ) );
+  this->all->insert( stabbedOf( registered.all, id ) );
+  this->liveIntervals += registered.releases.size() + registered.all.size();
+  return id;
+}
+
+
+  bool
+RangeIndex::erase( Id id )
+{
+  auto found = this->ranges.find( id );
+  if ( found == this->ranges.end() )
+    {
+      return false;
+    }
+  const size_t n = found->second.releases.size() + found->second.all.size();
+  this->liveIntervals -= n;
+  this->deadIntervals += n;
+  this->erased.push_back( std::move( found->second ) );
+  this->ranges.erase( found );
+  if ( this->liveIntervals < this->deadIntervals )
+    {
+      this->rebuild();
+    }
+  return true;
+}
+
+
+  void
+RangeIndex::rebuild()
+{
+  std::vector<Stabbed> releases;
+  std::vector<Stabbed> all;
+  for ( const auto & [id, registered] : this->ranges )
+    {
+      for ( const Stabbed & s : stabbedOf( registered.releases, id ) )
+        {
+          releases.push_back( s );
+        }
+      for ( const Stabbed & s : stabbedOf( registered.all, id ) )
+        {
+          all.push_back( s );
+        }
+    }
+  * this->releases = IntervalForest();
+  * this->all      = IntervalForest();
+  this->releases->insert( std::move( releases ) );
+  this->all->insert( std::move( all ) );
+  this->erased.clear();
+  this->deadIntervals = 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  std::vector<RangeIndex::Id>
+RangeIndex::stab( const SemVer & version ) const
+{
+  std::vector<Id> rsl;
+  if ( ( version.key & 1 ) != 0 )
+    {
+      this->releases->stab( version, rsl );
+    }
+  this->all->stab( version, rsl );
+  if ( this->deadIntervals != 0 )
+    {
+      rsl.erase( std::remove_if( rsl.begin(), rsl.end()
+                               , [&]( Id id )
+                                 {
+                                   return ! this->ranges.contains( id );
+                                 }
+                               )
+               , rsl.end()
+               );
+    }
+  return rsl;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
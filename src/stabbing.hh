@@ -0,0 +1,118 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "interval.hh"
+#include "range.hh"
+#include "semver.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/** A set of `RangeIndex' intervals, searchable by the versions they contain. */
+struct IntervalForest;
+
+/**
+ * A reverse index from versions to the registered ranges which accept them,
+ * answering which ranges accept a newly published version without testing
+ * each one.
+ *
+ * Each range's compiled intervals are kept in priority search trees, which
+ * are binary search trees on lower bounds and heaps on upper bounds.
+ * A stabbing query reports the intervals in a tree containing a version in
+ * O( log n + k ) time, for k intervals reported.
+ * Trees are static, so they are kept in levels of doubling sizes: an insert
+ * rebuilds the levels below the first empty one into it, in O( log^2 n )
+ * amortized time, and a query searches each level, in O( log^2 n + k ).
+ * Erased ranges are skipped by queries until they make up half the index,
+ * when it is rebuilt without them.
+ *
+ * Releases are looked up in the intervals of ranges which only accept them,
+ * and all versions in the intervals of ranges including pre-releases and in
+ * ranges' pre-release allowances, so each accepting range is found once.
+ */
+struct RangeIndex {
+
+/* -------------------------------------------------------------------------- */
+
+    using Id = uint64_t;
+
+    RangeIndex();
+    ~RangeIndex();
+
+    RangeIndex( const RangeIndex & ) = delete;
+    RangeIndex & operator=( const RangeIndex & ) = delete;
+
+    /**
+     * Register `range', returning the id it is reported by.
+     * Ids are never reused.
+     */
+    Id insert( const Range & range );
+
+    /** Unregister the range with id `id', returning whether there was one. */
+    bool erase( Id id );
+
+    /** The number of registered ranges. */
+    size_t size() const { return this->ranges.size(); }
+
+    /**
+     * The ids of registered ranges which accept `version', as `Range::test'
+     * does, in no particular order.
+     */
+    std::vector<Id> stab( const SemVer & version ) const;
+
+
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    /** The intervals a range was registered with. */
+    struct Registered {
+      std::vector<Interval> releases;
+      std::vector<Interval> all;
+    };
+
+    /** Intervals accepting releases only, and those accepting any version. */
+    std::unique_ptr<IntervalForest> releases;
+    std::unique_ptr<IntervalForest> all;
+
+    /**
+     * Registered ranges, whose intervals are referred to by the forests.
+     * Erased ranges are kept in `erased' until the forests are rebuilt.
+     */
+    std::unordered_map<Id, Registered> ranges;
+    std::vector<Registered>            erased;
+    size_t                             liveIntervals = 0;
+    size_t                             deadIntervals = 0;
+    Id                                 nextId        = 0;
+
+    void rebuild();
+
+
+/* -------------------------------------------------------------------------- */
+
+};  /* End struct `RangeIndex' */
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -5,7 +5,33 @@
  * -------------------------------------------------------------------------- */
 
 #include "semver.hh"
+#include "compact.hh"
+#include "view.hh"
+#include "comparator.hh"
+#include "range.hh"
+#include "intern.hh"
+#include "cache.hh"
+#include "catalog.hh"
+#include "rcu.hh"
+#include "compressed.hh"
+#include "stabbing.hh"
+#include "bitset.hh"
+#include "timed.hh"
+#include "sort.hh"
+#include "flat.hh"
+#include "regexes.hh"
+#include <algorithm>
+#include <atomic>
+#include <initializer_list>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
 
 using namespace semi;
 
@@ -23,12 +49,2354 @@ semver_class()
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Parse `version' with the reference regex patterns, the way `SemVer' used to
+ * before it had a hand written scanner.
+ */
+  static std::optional<SemVer>
+regexSemVer( const std::string & version, bool loose )
+{
+  const std::regex pattern( loose ? re::LOOSE : re::FULL );
+  std::smatch      match;
+  if ( ! std::regex_match( version, match, pattern ) )
+    {
+      return std::nullopt;
+    }
+
+  auto split = []( const std::string & ids ) {
+    std::vector<std::string> rsl;
+    std::istringstream       iss( ids );
+    std::string              part;
+    while ( std::getline( iss, part, '.' ) )
+      {
+        rsl.push_back( part );
+      }
+    return rsl;
+  };
+
+  /* The scanner rejects parts which do not fit in an `unsigned int'. */
+  auto number = []( const std::string & part ) {
+    const unsigned long n = std::stoul( part );
+    if ( std::numeric_limits<unsigned int>::max() < n )
+      {
+        throw std::out_of_range( part );
+      }
+    return static_cast<unsigned int>( n );
+  };
+
+  return SemVer( number( match[1] ), number( match[2] ), number( match[3] )
+               , split( match[4].matched ? match[4].str() : "" )
+               , split( match[5].matched ? match[5].str() : "" )
+               );
+}
+
+
+/**
+ * The scanner must accept exactly the strings that `re::FULL' and `re::LOOSE'
+ * accept, and must split them into the same parts.
+ */
+  static bool
+semver_scanner()
+{
+  std::vector<std::string> inputs = {
+    "1.2.3", "v1.2.3", "=1.2.3", " =v1.2.3", "vv1.2.3", "01.2.3", "1.02.3",
+    "1.2.03", "1.2.3-0", "1.2.3-00", "1.2.3-01a", "1.2.3-a.01", "1.2.3alpha",
+    "1.2.3-", "1.2.3-.x", "1.2.3--x", "1.2.3-+b", "1.2.34.x", "1.2.3.4",
+    "1.2.3+", "1.2.3+a..b", "1.2.3-a+b.c-d", "1.2", "1.2.3 ", "",
+    "1.2.3-alpha.beta.1+build.001", "4294967295.0.0", "4294967296.0.0"
+  };
+
+  /* Random strings from version-ish tokens */
+  const char * tokens[] = {
+    "0", "1", "12", "01", ".", ".", "-", "+", "v", "=", " ", "a", "Z", "x",
+    "-0", "alpha", "_"
+  };
+  std::mt19937                          gen( 42 );
+  std::uniform_int_distribution<size_t> ntok( 1, 10 );
+  std::uniform_int_distribution<size_t> tok( 0, std::size( tokens ) - 1 );
+  for ( size_t i = 0; i < 5000; ++i )
+    {
+      std::string s = ( i % 2 ) ? "1.2.3" : "";
+      for ( size_t n = ntok( gen ); 0 < n; --n )
+        {
+          s += tokens[tok( gen )];
+        }
+      inputs.push_back( s );
+    }
+
+  for ( const std::string & s : inputs )
+    {
+      for ( bool loose : { false, true } )
+        {
+          std::optional<SemVer> expected;
+          try { expected = regexSemVer( s, loose ); }
+          catch ( const std::out_of_range & ) { continue; }
+
+          std::optional<SemVer> actual;
+          try { actual = SemVer( s, false, loose ); }
+          catch ( const std::invalid_argument & ) {}
+
+          if ( expected.has_value() != actual.has_value() )
+            {
+              std::cerr << "scanner mismatch: '" << s << "' loose=" << loose
+                        << std::endl;
+              return false;
+            }
+          if ( expected.has_value() &&
+               ( ( expected->toString() != actual->toString() ) ||
+                 ( expected->build != actual->build )
+               )
+             )
+            {
+              std::cerr << "scanner mismatch: '" << s << "' loose=" << loose
+                        << " '" << expected->toString() << "' != '"
+                        << actual->toString() << "'" << std::endl;
+              return false;
+            }
+        }
+    }
+
+  return
+    ( SemVer( "1.2.3-alpha.1+build" ).toString() == "1.2.3-alpha.1" ) &&
+    ( SemVer( "1.2.34.x", false, true ).toString() == "1.2.3-4.x" )
+  ;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+semver_compare()
+{
+  const std::vector<std::string> ordered = {
+    "0.0.0-0", "0.0.0", "0.0.1", "0.1.0-1", "0.1.0-9", "0.1.0-10",
+    "0.1.0-alpha", "0.1.0-alpha.1", "0.1.0-alpha.9", "0.1.0-alpha.10",
+    "0.1.0-alpha.10a", "0.1.0-alpha.9a", "0.1.0-beta", "0.1.0", "1.0.0",
+    "1.0.1", "1.255.0", "1.256.0", "256.0.0", "4294967295.0.0"
+  };
+  for ( size_t i = 0; i < ordered.size(); ++i )
+    {
+      for ( size_t j = 0; j < ordered.size(); ++j )
+        {
+          const char c = SemVer( ordered[i] ).compare( SemVer( ordered[j] ) );
+          if ( ( i < j ) ? ( 0 <= c )
+                         : ( ( j < i ) ? ( c <= 0 ) : ( c != 0 ) )
+             )
+            {
+              std::cerr << "compare: " << ordered[i] << " <=> " << ordered[j]
+                        << " = " << int( c ) << std::endl;
+              return false;
+            }
+        }
+    }
+
+  /* Pre-releases modified without calling `format'. */
+  SemVer grown( "1.2.3-alpha" );
+  grown.prerelease.push_back( "10" );
+  SemVer set( "1.2.3" );
+  set.prerelease = { "beta" };
+  const SemVer alpha9( "1.2.3-alpha.9" );
+
+  return
+    ( 0 < grown.comparePre( alpha9 ) ) && ( alpha9.comparePre( grown ) < 0 ) &&
+    ( 0 < set.comparePre( alpha9 ) ) && ( alpha9.comparePre( set ) < 0 ) &&
+    ( SemVer( "1.2.3+a" ).compare( SemVer( "1.2.3+b" ) ) == 0 ) &&
+    ( SemVer( "1.2.3+a" ).compareBuild( SemVer( "1.2.3+b" ) ) < 0 ) &&
+    ( SemVer( "1.2.3+9" ).compareBuild( SemVer( "1.2.3+10" ) ) < 0 ) &&
+    ( SemVer( "1.2.3-01", false, true ).compare(
+        SemVer( "1.2.3-1", false, true ) ) == 0
+    ) &&
+    ( SemVer( "1.2.3-99999999999999999999" ).compare(
+        SemVer( "1.2.3-100000000000000000000" ) ) < 0
+    ) &&
+    ( 0 < SemVer( "2.0.0" ).compareMain( SemVer( "1.9.9-rc" ) ) ) &&
+    ( SemVer( "1.2.3" ).compareMain( SemVer( "1.2.3-rc" ) ) == 0 )
+  ;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+compact_semver()
+{
+  const std::vector<std::string> versions = {
+    "1.2.3", "1.2.3-alpha.1", "1.2.3-alpha.1+build.5", "1.2.3+build",
+    "1.2.4-0", "0.0.0", "1.2.3-beta", "1.2.3+build.6", "1.2.3-alpha.10",
+    "1.2.3-alpha.9", "1.2.3+build.10"
+  };
+  for ( const std::string & a : versions )
+    {
+      const CompactSemVer ca( a );
+      const SemVer        sa( a );
+      const CompactSemVer copy = ca;
+      if ( ( ca.toString() != sa.toString() ) ||
+           ( copy.toSemVer().toString() != sa.toString() ) ||
+           ( CompactSemVer( sa ).build() != ca.build() )
+         )
+        {
+          return false;
+        }
+      for ( const std::string & b : versions )
+        {
+          const CompactSemVer cb( b );
+          const SemVer        sb( b );
+          if ( ( ca.compare( cb )      != sa.compare( sb ) )     ||
+               ( ca.compareMain( cb )  != sa.compareMain( sb ) ) ||
+               ( ca.comparePre( cb )   != sa.comparePre( sb ) )  ||
+               ( ca.compareBuild( cb ) != sa.compareBuild( sb ) )
+             )
+            {
+              std::cerr << "compact compare: " << a << " <=> " << b
+                        << std::endl;
+              return false;
+            }
+        }
+    }
+
+  /* Members modified into an invalid version are rejected. */
+  SemVer eager( "1.2.3" );
+  eager.build = { "bad id" };
+  SemVer lazy = SemVer::parseLazy( "1.2.3-alpha" );
+  lazy.raw = "1.2.3-al pha";
+  for ( const SemVer * semver : { & eager, & lazy } )
+    {
+      bool threw = false;
+      try
+        {
+          CompactSemVer compact( * semver );
+        }
+      catch ( const std::invalid_argument & )
+        {
+          threw = true;
+        }
+      if ( ! threw )
+        {
+          std::cerr << "compact: invalid members" << std::endl;
+          return false;
+        }
+    }
+
+  return
+    ( CompactSemVer( "=v1.2.3alpha", true ).prerelease() == "alpha" ) &&
+    ( CompactSemVer( "1.2.3" ).toSemVer().raw == "1.2.3" )
+  ;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+semver_view()
+{
+  const std::string buffer = "v1.2.3-alpha.10+build.7";
+  const SemVerView  view( buffer );
+
+  std::vector<std::string_view> pre( view.prerelease().begin()
+                                   , view.prerelease().end()
+                                   );
+  std::vector<std::string_view> build( view.build().begin()
+                                     , view.build().end()
+                                     );
+  if ( ( view.major() != 1 ) || ( view.minor() != 2 ) || ( view.patch() != 3 )
+       || ( pre != std::vector<std::string_view> { "alpha", "10" } )
+       || ( build != std::vector<std::string_view> { "build", "7" } )
+       || ( pre[0].data() != ( buffer.data() + 7 ) )
+       || ( view.toString() != "1.2.3-alpha.10" )
+       || SemVerView::parse( "1.2" ).has_value()
+     )
+    {
+      return false;
+    }
+
+  const std::vector<std::string> versions = {
+    "1.2.3", "1.2.3-alpha.1", "1.2.3-alpha", "1.2.4-0", "0.9.0+b", "2.0.0",
+    "1.2.3-alpha.10", "1.2.3-alpha.9"
+  };
+  for ( const std::string & a : versions )
+    {
+      for ( const std::string & b : versions )
+        {
+          const SemVer sb( b );
+          if ( ( SemVerView( a ).compare( SemVerView( b ) ) !=
+                 SemVer( a ).compare( sb ) ) ||
+               ( SemVerView( a ).compare( sb ) != SemVer( a ).compare( sb ) ) ||
+               ( SemVerView( a ).comparePre( sb ) !=
+                 SemVer( a ).comparePre( sb ) )
+             )
+            {
+              std::cerr << "view compare: " << a << " <=> " << b << std::endl;
+              return false;
+            }
+        }
+    }
+
+  const Comparator gte( ">=1.2.3" );
+  const Comparator lt( "<2.0.0" );
+  return
+    gte.test( SemVerView( "1.2.3" ) ) && gte.test( SemVerView( "1.10.0" ) ) &&
+    ( ! gte.test( SemVerView( "1.2.3-rc" ) ) ) && lt.test( "1.9.9" ) &&
+    ( ! lt.test( "2.0.0" ) ) && ( ! lt.test( "not a version" ) ) &&
+    Range( gte ).test( SemVerView( "3.0.0" ) ) &&
+    ( ! Range( gte ).test( SemVerView( "1.5.0-rc" ) ) ) &&
+    Range( Comparator( ">=1.5.0-alpha" ) ).test( SemVerView( "1.5.0-rc" ) ) &&
+    Range( gte ).test( SemVerView( "1.5.0-rc" ), true )
+  ;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+semver_lazy()
+{
+  const std::vector<std::string> versions = {
+    "1.2.3", "1.2.3-alpha.1", "1.2.3-alpha", "1.2.3+b.1", "1.2.3-rc+b.2",
+    "2.0.0", "1.2.3-alpha.10", "1.2.3-alpha.9+b.10", "1.2.3+b.9"
+  };
+  for ( const std::string & a : versions )
+    {
+      const SemVer la = SemVer::parseLazy( a );
+      const SemVer ea( a );
+      if ( ( ! la.lazy ) || ( ! la.prerelease.empty() ) ||
+           ( la.toString() != ea.toString() )
+         )
+        {
+          return false;
+        }
+      for ( const std::string & b : versions )
+        {
+          const SemVer lb = SemVer::parseLazy( b );
+          const SemVer eb( b );
+          if ( ( la.compare( lb ) != ea.compare( eb ) )           ||
+               ( la.compare( eb ) != ea.compare( eb ) )           ||
+               ( ea.compare( lb ) != ea.compare( eb ) )           ||
+               ( la.compareBuild( lb ) != ea.compareBuild( eb ) ) ||
+               ( la.compareBuild( eb ) != ea.compareBuild( eb ) ) ||
+               ( ea.compareBuild( lb ) != ea.compareBuild( eb ) )
+             )
+            {
+              std::cerr << "lazy compare: " << a << " <=> " << b << std::endl;
+              return false;
+            }
+        }
+    }
+
+  SemVer lazy = SemVer::parseLazy( "v1.2.3-rc.1+build.5", false, true );
+  return
+    ( lazy.getBuild() == std::vector<std::string> { "build", "5" } ) &&
+    ( ! lazy.lazy ) && ( lazy.version == "1.2.3-rc.1" ) &&
+    ( lazy.prerelease == std::vector<std::string> { "rc", "1" } ) &&
+    ( CompactSemVer( SemVer::parseLazy( "1.2.3+b" ) ).build() == "b" )
+  ;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+string_compare()
+{
+  const std::vector<std::string> versions = {
+    "1.2.3", "1.2.3-alpha.1", "1.2.3-alpha", "1.2.3+b.1", "1.2.3-rc+b.2",
+    "2.0.0", "1.2.3-alpha.10", "0.1.2", "1.10.3", "v1.2.3", "=1.2.3-9",
+    "1.2", "01.2.3", "1.2.3-", ""
+  };
+  for ( bool loose : { false, true } )
+    {
+      for ( const std::string & a : versions )
+        {
+          for ( const std::string & b : versions )
+            {
+              std::optional<char> expected;
+              try
+                {
+                  const SemVer sa( a, false, loose );
+                  expected = sa.compare( SemVer( b, false, loose ) );
+                }
+              catch ( const std::invalid_argument & ) {}
+              if ( semi::compare( a, b, loose ) != expected )
+                {
+                  std::cerr << "string compare: " << a << " <=> " << b
+                            << std::endl;
+                  return false;
+                }
+            }
+        }
+    }
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+struct RangeCase {
+  const char * range;
+  const char * version;
+  bool         includePrerelease;
+  bool         loose;
+  bool         expected;
+};
+
+/**
+ * Test a version against each comparator of a range, the way the reference
+ * implementation does, to check the compiled intervals against.
+ */
+  static bool
+referenceTest( const Range & range
+             , const SemVer & version
+             ,       bool     includePrerelease
+             )
+{
+  for ( const std::vector<Comparator> & comps : range.set )
+    {
+      bool ok = true;
+      for ( const Comparator & comp : comps )
+        {
+          ok = ok && comp.test( version );
+        }
+      if ( ! ok )
+        {
+          continue;
+        }
+      if ( version.prerelease.empty() || includePrerelease )
+        {
+          return true;
+        }
+      for ( const Comparator & comp : comps )
+        {
+          if ( comp.semver.major.has_value() &&
+               ( ! comp.semver.prerelease.empty() ) &&
+               ( comp.semver.compareMain( version ) == 0 )
+             )
+            {
+              return true;
+            }
+        }
+    }
+  return false;
+}
+
+
+  static bool
+range_test()
+{
+  const std::vector<RangeCase> cases = {
+    { "1.0.0 - 2.0.0", "1.2.3", false, false, true },
+    { "^1.2.3+build", "1.3.0", false, false, true },
+    { "1.2.3-pre+asdf - 2.4.3-pre+asdf", "1.2.3-pre.2", false, false, true },
+    { "1.2.3-pre+asdf - 2.4.3-pre+asdf", "2.4.3-alpha", false, false, true },
+    { "1.2.3pre+asdf - 2.4.3-pre+asdf", "1.2.3", false, true, true },
+    { ">=*", "0.2.4", false, false, true },
+    { "", "1.0.0", false, false, true },
+    { "*", "v1.2.3", false, true, true },
+    { ">1.0.0", "1.0.1", false, false, true },
+    { "<=   2.0.0", "2.0.0", false, false, true },
+    { ">=0.2.3 || <0.0.1", "0.0.0", false, false, true },
+    { "||", "1.3.4", false, false, true },
+    { "1.2.x || 2.x", "2.1.3", false, false, true },
+    { "~ 1.0.3alpha", "1.0.12", false, true, true },
+    { "~v0.5.4-pre", "0.5.4", false, false, true },
+    { "<=0.7.x", "0.7.2", false, false, true },
+    { "~1.2.1 >=1.2.3 1.2.3", "1.2.3", false, false, true },
+    { "^1.2 ^1", "1.4.2", false, false, true },
+    { "^1.2.3-alpha", "1.2.3-pre", false, false, true },
+    { "^0.0.1-alpha", "0.0.1-beta", false, false, true },
+    { "x - 1.x", "0.9.7", false, false, true },
+    { "<=7.x", "7.9.9", false, false, true },
+    { "2.x", "2.1.0-pre.0", true, false, true },
+    { "^1.0.0-rc2", "1.0.1-rc1", true, false, true },
+    { "^1.0.0", "1.1.0-rc1", true, false, true },
+    { "1 - 2", "2.0.0-pre", true, false, true },
+    { "1.0 - 2", "1.0.0-pre", true, false, true },
+    { "<=0.7.x", "0.7.0-asdf", true, false, true },
+    { ">=1.0.0 <=1.1.0", "1.1.0-pre", true, false, true },
+    { "1.0.0 - 2.0.0", "2.2.3", false, false, false },
+    { "1.2.3+asdf - 2.4.3+asdf", "2.4.3-alpha", false, false, false },
+    { "^1.2.3", "1.2.3-pre", false, false, false },
+    { ">1.2", "1.3.0-beta", false, false, false },
+    { "<=1.2.3", "1.2.3-beta", false, false, false },
+    { "=0.7.x", "0.7.0-asdf", false, false, false },
+    { "<1", "1.0.0beta", false, true, false },
+    { "<=2.0.0", "2.9999.9999", false, false, false },
+    { ">=0.2.3 || <0.0.1", "0.2.2", false, false, false },
+    { "~0.0.1", "0.1.0-alpha", false, false, false },
+    { "~>3.2.1", "3.2.0", false, false, false },
+    { "~v0.5.4-beta", "0.5.4-alpha", false, false, false },
+    { "=1.2.3", "1.2.3-beta", false, false, false },
+    { ">1.2", "1.2.8", false, false, false },
+    { "^0.0.1", "0.0.2-alpha", false, false, false },
+    { "^1.2.3", "2.0.0-alpha", false, false, false },
+    { "*", "v1.2.3-foo", false, true, false },
+    { "^1.0.0", "1.0.0-rc1", true, false, false },
+    { "^1.2.3-rc2", "2.0.0", true, false, false },
+    { "1 - 2", "3.0.0-pre", true, false, false },
+    { "1 - 2", "1.0.0-pre", false, false, false },
+    { "1.1.x", "1.2.0-a", true, false, false },
+    { "1.x", "0.0.0-a", true, false, false },
+    { ">=1.0.0 <1.1.0", "1.1.0-pre", false, false, false },
+    { ">=1.0.0 <1.1.0-pre", "1.1.0-pre", false, false, false },
+    { "== 1.0.0 || foo", "2.0.0", false, true, false },
+    { "<0.0.0-0", "0.0.0-0", true, false, false },
+  };
+
+  for ( const RangeCase & c : cases )
+    {
+      const Range range( c.range, c.includePrerelease, c.loose );
+      if ( range.test( std::string_view( c.version ), false, c.loose ) !=
+           c.expected
+         )
+        {
+          std::cerr << "range test: '" << c.range << "' " << c.version
+                    << std::endl;
+          return false;
+        }
+    }
+
+  const std::vector<std::pair<std::string, std::string>> desugared = {
+    { "1.2.3 - 2.3.4", ">=1.2.3 <=2.3.4" },
+    { "~1.2.3", ">=1.2.3 <1.3.0-0" },
+    { "^0.0.1", ">=0.0.1 <0.0.2-0" },
+    { "^0.1", ">=0.1.0 <0.2.0-0" },
+    { "> 1.2", ">=1.3.0" },
+    { "1.2.x || 2.x", ">=1.2.0 <1.3.0-0||>=2.0.0 <3.0.0-0" },
+    { ">=*", "" },
+    { "* 1.2.3", "1.2.3" },
+  };
+  for ( const auto & [range, expected] : desugared )
+    {
+      if ( Range( range ).toString() != expected )
+        {
+          std::cerr << "range format: '" << range << "' => '"
+                    << Range( range ).toString() << "'" << std::endl;
+          return false;
+        }
+    }
+
+  /* Check the compiled intervals against testing each comparator. */
+  const std::vector<std::string> versions = {
+    "0.0.0-0", "0.0.0", "0.0.1", "0.0.2-0", "0.1.0", "0.1.2", "0.2.0-0",
+    "1.0.0-0", "1.0.0-rc.1", "1.0.0", "1.0.1-rc1", "1.1.0-pre", "1.1.0",
+    "1.2.2", "1.2.3-alpha", "1.2.3-alpha.0", "1.2.3-beta", "1.2.3",
+    "1.2.4-0", "1.3.0-0", "1.3.0", "2.0.0-0", "2.0.0-alpha", "2.0.0",
+    "2.4.3-alpha", "2.4.3", "3.0.0-0", "3.0.0", "4294967295.0.0"
+  };
+  for ( const RangeCase & c : cases )
+    {
+      for ( bool includePrerelease : { false, true } )
+        {
+          const Range range( c.range, c.includePrerelease, c.loose );
+          for ( const std::string & v : versions )
+            {
+              const SemVer version( v );
+              const bool   incPre = includePrerelease || c.includePrerelease;
+              if ( range.test( version, includePrerelease ) !=
+                   referenceTest( range, version, incPre )
+                 )
+                {
+                  std::cerr << "range reference: '" << c.range << "' " << v
+                            << std::endl;
+                  return false;
+                }
+            }
+        }
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+range_intersect()
+{
+  struct ComparatorCase {
+    const char * a;
+    const char * b;
+    bool         includePrerelease;
+    bool         expected;
+  };
+  const std::vector<ComparatorCase> comparators = {
+    { "1.3.0", ">=1.3.0", false, true },
+    { "1.3.0", ">1.3.0", false, false },
+    { ">1.2.0", ">=1.3.0", false, true },
+    { "<1.3.0", "<1.2.0", false, true },
+    { ">=1.3.0", "<=1.3.0", false, true },
+    { "<1.3.0", "<=1.3.0", false, true },
+    { ">1.3.0", "<=1.3.0", false, false },
+    { ">1.0.0", "<2.0.0", false, true },
+    { "<=1.0.0", ">=2.0.0", false, false },
+    { "1.3.0-beta", ">=1.3.0", false, false },
+    { ">=1.3.0-beta", "<1.3.0", false, true },
+    { "", "", false, true },
+    { "", ">1.0.0", false, true },
+    { "<0.0.0", "<0.1.0", false, false },
+    { "<0.0.0", "<0.1.0", true, true },
+    { "<0.0.0-0", "<0.1.0", true, false },
+  };
+  for ( const ComparatorCase & c : comparators )
+    {
+      if ( Comparator( c.a ).intersects( Comparator( c.b )
+                                       , c.includePrerelease
+                                       ) != c.expected
+         )
+        {
+          std::cerr << "comparator intersects: '" << c.a << "' '" << c.b
+                    << "'" << std::endl;
+          return false;
+        }
+    }
+
+  struct IntersectCase {
+    Range       a;
+    Range       b;
+    std::string expected;
+  };
+  const std::vector<IntersectCase> ranges = {
+    { Range( "^1.2.3" ), Range( "~1.4.0" ), ">=1.4.0 <1.5.0-0" },
+    { Range( "1.x" ), Range( "2.x" ), "<0.0.0-0" },
+    { Range( "^1.2.3-alpha" ), Range( ">=1.0.0 <2.0.0" )
+    , ">=1.2.3 <2.0.0-0"
+    },
+    { Range( "^1.2.3-alpha" ), Range( "^1.2.3-beta" )
+    , ">=1.2.3-beta <2.0.0-0"
+    },
+    { Range( "1.2.7 || >=1.2.9 <2.0.0" ), Range( ">1.2.7" )
+    , ">=1.2.9 <2.0.0"
+    },
+    { Range( ">=1.0.0 <2.0.0", true ), Range( "1.x || 1.5.0-beta - 1.5.0" )
+    , ">=1.0.0 <2.0.0-0||>=1.5.0-beta <1.5.0"
+    },
+    { Range( "^1.0.0", true ), Range( "<=1.2.3-rc", true )
+    , ">=1.0.0 <=1.2.3-rc"
+    },
+  };
+  for ( const IntersectCase & c : ranges )
+    {
+      if ( c.a.intersect( c.b ).toString() != c.expected )
+        {
+          std::cerr << "range intersect: '" << c.a.toString() << "' '"
+                    << c.b.toString() << "' => '"
+                    << c.a.intersect( c.b ).toString() << "'" << std::endl;
+          return false;
+        }
+    }
+
+  if ( Range( "<0.0.0" ).intersects( Range( "*" ) ) ||
+       ( ! Range( "<0.0.0" ).intersects( Range( "*" ), true ) ) ||
+       ( ! Range( "^1.2.3-alpha" ).intersects( Range( "~1.2.3-beta" ) ) ) ||
+       Range( "^1.2.3-alpha" ).intersects( Range( "1.2.3-0 - 1.2.3-1" ) )
+     )
+    {
+      std::cerr << "range intersects" << std::endl;
+      return false;
+    }
+
+  /* Intersections accept what both ranges accept, as does their rendering. */
+  const std::vector<std::string> pool = {
+    "1.0.0 - 2.0.0", "^1.2.3", "~1.2.3-beta", "1.2.x || 2.x", "<1.2.3-rc",
+    "^0.0.1-alpha", ">=1.1.0 <1.3.0-0 || 2.0.0-alpha.1", ">1.2.3", "*",
+    "1.2.3-alpha - 1.2.3-beta.2 || ^2.0.0-0"
+  };
+  const std::vector<std::string> versions = {
+    "0.0.1-alpha.1", "0.0.1", "1.0.0", "1.2.2", "1.2.3-alpha", "1.2.3-beta",
+    "1.2.3-beta.1", "1.2.3-rc", "1.2.3", "1.2.4-0", "1.2.9", "1.3.0-rc",
+    "2.0.0-alpha.1", "2.0.0", "2.1.0-rc", "3.0.0"
+  };
+  for ( bool incA : { false, true } )
+    {
+      for ( const std::string & ra : pool )
+        {
+          for ( const std::string & rb : pool )
+            {
+              const Range a( ra, incA );
+              const Range b( rb );
+              const Range both     = a.intersect( b );
+              const Range rendered( both.toString() );
+              bool        accepted = false;
+              for ( const std::string & v : versions )
+                {
+                  const bool expected = a.test( v ) && b.test( v );
+                  accepted = accepted || expected;
+                  if ( ( both.test( v ) != expected ) ||
+                       ( rendered.test( v ) != expected )
+                     )
+                    {
+                      std::cerr << "range intersect: '" << ra << "' '" << rb
+                                << "' " << v << std::endl;
+                      return false;
+                    }
+                }
+              if ( accepted && ( ! a.intersects( b ) ) )
+                {
+                  std::cerr << "range intersects: '" << ra << "' '" << rb
+                            << "'" << std::endl;
+                  return false;
+                }
+            }
+        }
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+range_simplify()
+{
+  const std::vector<std::pair<std::string, std::string>> minimal = {
+    { ">=1.0.0 <2.0.0 || >=1.5.0 <1.8.0 || 1.2.3 || ^1.4", ">=1.0.0 <2.0.0" },
+    { "1.2.3 || 1.2.4 || 1.2.5", ">=1.2.3 <1.2.6-0" },
+    { "^1.2.3-beta || ~1.2.3-alpha", ">=1.2.3-alpha <2.0.0-0" },
+    { "* || 1.2.3", "" },
+    { "1.x || >=1.5.0-beta <1.5.0", ">=1.0.0 <2.0.0-0||>=1.5.0-beta <1.5.0" },
+  };
+  for ( const auto & [range, expected] : minimal )
+    {
+      const Range simple = Range( range ).simplify();
+      if ( simple.toString() != expected )
+        {
+          std::cerr << "range simplify: '" << range << "' => '"
+                    << simple.toString() << "'" << std::endl;
+          return false;
+        }
+    }
+
+  /* Simplified ranges, and their rendering, accept the same versions. */
+  const std::vector<std::string> pool = {
+    "1.2.3 || 1.2.4-rc || 1.2.5", "^1.2.3-alpha || 1.2.4-beta - 1.2.4",
+    "1.2.3-alpha - 1.2.3-beta || 1.2.3 - 1.2.4 || 1.2.4-alpha.2",
+    "<1.2.3 || 1.2.5-0 - 2", ">1.2.3-alpha <1.2.3-beta || >=1.2.3 <1.2.4-alpha"
+  };
+  const std::vector<std::string> candidates = {
+    "0.0.0-0", "0.0.0", "1.2.2", "1.2.3-alpha", "1.2.3-alpha.1", "1.2.3-beta",
+    "1.2.3-gamma", "1.2.3", "1.2.4-0", "1.2.4-alpha", "1.2.4-alpha.2",
+    "1.2.4-beta", "1.2.4-rc", "1.2.4", "1.2.5-0", "1.2.5", "1.3.0-rc", "2.0.0",
+    "2.0.1-rc"
+  };
+  for ( bool includePrerelease : { false, true } )
+    {
+      for ( const std::string & r : pool )
+        {
+          const Range range( r, includePrerelease );
+          const Range simple = range.simplify();
+          const Range rendered( simple.toString(), includePrerelease );
+          for ( const std::string & v : candidates )
+            {
+              if ( ( simple.test( v ) != range.test( v ) ) ||
+                   ( rendered.test( v ) != range.test( v ) )
+                 )
+                {
+                  std::cerr << "range simplify: '" << r << "' => '"
+                            << simple.toString() << "' " << v << std::endl;
+                  return false;
+                }
+            }
+        }
+    }
+
+  std::vector<SemVer> versions;
+  for ( const char * v : { "1.0.0", "1.0.1", "1.0.2", "1.0.3", "1.0.4", "1.1.0"
+                         , "1.1.1", "1.1.2", "1.2.0", "1.2.1", "1.2.2", "1.2.3"
+                         , "1.2.4", "1.2.5", "2.0.0", "2.0.1", "2.1.0", "2.1.1"
+                         , "3.0.0", "3.0.1", "3.1.0", "3.2.0"
+                         }
+      )
+    {
+      versions.emplace_back( v );
+    }
+  /* Shuffle the catalog, which need not be sorted. */
+  std::shuffle( versions.begin(), versions.end(), std::mt19937( 7 ) );
+
+  const std::vector<std::pair<std::string, std::string>> catalog = {
+    { "1.x", "1.x" },
+    { "1.0.0 || 1.0.1 || 1.0.2 || 1.0.3 || 1.0.4", "<=1.0.4" },
+    { ">=3.0.0 <3.1.0", "3.0.0 - 3.0.1" },
+    { "3.0.0 || 3.1 || 3.2", "3.0.0 || >=3.1.0" },
+    { "1 || 2 || 3", "*" },
+    { "2.1 || 2.2 || 2.3", "2.1.0 - 2.1.1" },
+    { "4.1 || 4.2 || 4.3", "<0.0.0-0" },
+  };
+  for ( const auto & [range, expected] : catalog )
+    {
+      const Range simple = Range( range ).simplify( versions );
+      if ( simple.raw != expected )
+        {
+          std::cerr << "range simplify: '" << range << "' => '" << simple.raw
+                    << "'" << std::endl;
+          return false;
+        }
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Versions at and just above the bounds of a range's intervals.
+ * If one range is not a subset of another, one of these is a witness.
+ */
+  static void
+addWitnesses( const Range & range, std::vector<SemVer> & rsl )
+{
+  std::vector<SemVer> bounds;
+  for ( const std::vector<Interval> * intervals :
+          { & range.compiled.intervals, & range.compiled.prerelease }
+      )
+    {
+      for ( const Interval & i : * intervals )
+        {
+          bounds.push_back( i.lower );
+          if ( i.upper.has_value() )
+            {
+              bounds.push_back( * i.upper );
+            }
+        }
+    }
+  for ( const SemVer & b : bounds )
+    {
+      rsl.push_back( b );
+      rsl.push_back( SemVer( b.major, b.minor, b.patch ) );
+      if ( std::optional<SemVer> next = successor( rsl.back() ) )
+        {
+          rsl.push_back( * next );
+        }
+    }
+}
+
+
+/**
+ * Ranges with pre-releases and bounds at the ends of the version space,
+ * shared by the range tests, followed by `extra'.
+ */
+  static std::vector<std::string>
+rangePool( std::initializer_list<std::string> extra = {} )
+{
+  std::vector<std::string> pool = {
+    "^1.2.3-alpha", "1.x || 2.0.0-rc.1", "<1.2.3-beta || >=1.2.3", "*",
+    ">=1.2.3-alpha.1 <2.0.0-rc.2", "~1.2.3-0", "1.2.3 - 2.0.0-rc.1",
+    "<0.0.0-0", "1.2.x >=1.2.3", "1.2.3-alpha - 1.2.3-beta", ">=2.0.0"
+  };
+  pool.insert( pool.end(), extra.begin(), extra.end() );
+  return pool;
+}
+
+
+/** The witnesses of every range in `pool', followed by `extra' versions. */
+  static std::vector<SemVer>
+poolWitnesses( const std::vector<std::string>            & pool
+             ,       std::initializer_list<const char *>   extra = {}
+             )
+{
+  std::vector<SemVer> rsl;
+  for ( const std::string & r : pool )
+    {
+      addWitnesses( Range( r ), rsl );
+    }
+  for ( const char * v : extra )
+    {
+      rsl.emplace_back( v );
+    }
+  return rsl;
+}
+
+
+  static bool
+range_subset()
+{
+  struct SubsetCase {
+    const char * sub;
+    const char * dom;
+    bool         includePrerelease;
+    bool         expected;
+  };
+  const std::vector<SubsetCase> cases = {
+    { "1.2.3", "1.2.3", false, true },
+    { "1.2.3", "1.x", false, true },
+    { "1.2.3 1.2.4", "1.2.3", false, true },
+    { "1.2.3 2.3.4 || 2.3.4", "3", false, false },
+    { "^1.2.3-pre.0", "1.x", false, false },
+    { "^1.2.3-pre.0", "1.x", true, true },
+    { ">2 <1", "3", false, true },
+    { "1 || 2 || 3", ">=1.0.0", false, true },
+    { "*", "*", false, true },
+    { "", "*", false, true },
+    { "*", ">=0.0.0-0", false, true },
+    { "*", ">=0.0.0", true, false },
+    { "*", ">=0.0.0-0", true, true },
+    { "^2 || ^3 || ^4", ">=2", false, true },
+    { "^2 || ^3 || ^4", ">=3", false, false },
+    { ">=2", "^2 || ^3 || ^4", false, false },
+    { "1.x", "^1.2.3", false, false },
+    { ">1.2.3", ">=1.2.3", false, true },
+    { ">=1.2.3", ">1.2.3", false, false },
+    { "<1.2.3", "<=1.2.3", false, true },
+    { "1.2.3 - 2.3.4", ">=1.2.3 <=2.3.4", false, true },
+    { "<1", "<1.0.0", false, true },
+    { "<1.0.0", "<1", false, true },
+    { "<1.0.0", "<1", true, false },
+    { "1.2.3 || 1.2.4", ">=1.2.3 <1.2.5-0", false, true },
+    { "^1.2.3-alpha", ">=1.2.3-alpha.1 <2", false, false },
+    { "^1.2.3-beta", "^1.2.3-alpha", false, true },
+  };
+  for ( const SubsetCase & c : cases )
+    {
+      const Range sub( c.sub, c.includePrerelease );
+      const Range dom( c.dom, c.includePrerelease );
+      if ( subset( sub, dom ) != c.expected )
+        {
+          std::cerr << "range subset: '" << c.sub << "' '" << c.dom << "'"
+                    << std::endl;
+          return false;
+        }
+    }
+
+  const std::vector<std::string> pool = {
+    "1.2.3", "1.x", "^1.2.3-pre.0", "1.2.3 || 1.2.4", ">=1.2.3 <1.2.5-0",
+    "^1.2.3-alpha || 2.0.0-rc.1", ">=1.2.3-alpha.1 <2", "<1.2.3-0 || >1.2.4",
+    "~1.2.4-beta", "1.2.4-0 - 1.2.4-beta.2", "*", "<0.0.0", ">2.0.0-rc",
+    "<2.0.0-0 || 2.0.0-rc.1 - 2.0.0-rc.2", "1.2.3-alpha - 1.2.4-0"
+  };
+  for ( bool incSub : { false, true } )
+    {
+      for ( bool incDom : { false, true } )
+        {
+          for ( const std::string & rs : pool )
+            {
+              for ( const std::string & rd : pool )
+                {
+                  const Range         sub( rs, incSub );
+                  const Range         dom( rd, incDom );
+                  std::vector<SemVer> witnesses;
+                  addWitnesses( sub, witnesses );
+                  addWitnesses( dom, witnesses );
+                  bool expected = true;
+                  for ( const SemVer & v : witnesses )
+                    {
+                      expected = expected &&
+                                 ( dom.test( v ) || ( ! sub.test( v ) ) );
+                    }
+                  if ( subset( sub, dom ) != expected )
+                    {
+                      std::cerr << "range subset: '" << rs << "' '" << rd
+                                << "'" << std::endl;
+                      return false;
+                    }
+                }
+            }
+        }
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+range_intersect_all()
+{
+  const std::vector<Range> ranges = {
+    Range( "^1.2.0" ), Range( ">=1.3.0" ), Range( "<1.5.0" ), Range( "~1.4.2" )
+  };
+  std::vector<size_t> conflict = { 42 };
+  const Range         all      = Range::intersect( ranges, & conflict );
+  if ( ( all.toString() != ">=1.4.2 <1.5.0-0" ) || ( ! conflict.empty() ) )
+    {
+      std::cerr << "range intersect all: '" << all.toString() << "'"
+                << std::endl;
+      return false;
+    }
+
+  const std::vector<Range> conflicting = {
+    Range( "^1.0.0" ), Range( ">=1.2.0" ), Range( "2.x" ), Range( "<1.5.0" ),
+    Range( "*" )
+  };
+  if ( ( Range::intersect( conflicting, & conflict ).toString() !=
+         "<0.0.0-0"
+       ) ||
+       ( conflict != std::vector<size_t> { 2, 3 } )
+     )
+    {
+      std::cerr << "range intersect all: conflict" << std::endl;
+      return false;
+    }
+
+  /* Only pre-releases are left, which the last range does not allow. */
+  const std::vector<Range> prereleases = {
+    Range( ">=1.0.0-0" ), Range( "<1.0.0", true ), Range( "<1.0.0" )
+  };
+  if ( ( ! Range::intersect( { prereleases.data(), 2 } ).test( "1.0.0-1" ) ) ||
+       Range::intersect( prereleases, & conflict ).test( "1.0.0-1" ) ||
+       ( conflict != std::vector<size_t> { 0, 2 } ) ||
+       ( ! Range::intersect( {} ).test( "1.0.0-1", true ) )
+     )
+    {
+      std::cerr << "range intersect all: pre-releases" << std::endl;
+      return false;
+    }
+
+  /* Agrees with intersecting pairwise. */
+  const std::vector<std::string> pool = rangePool( { "!=1.2.4" } );
+  std::mt19937 gen( 12 );
+  for ( int round = 0; round < 200; ++round )
+    {
+      std::vector<Range> picked;
+      const size_t       n = 1 + gen() % 5;
+      for ( size_t i = 0; i < n; ++i )
+        {
+          std::string r = pool[gen() % pool.size()];
+          if ( r == "!=1.2.4" )
+            {
+              SemVer v( "1.2.4" );
+              picked.emplace_back( Comparator( "!=", v ), gen() % 2 == 0 );
+            }
+          else
+            {
+              picked.emplace_back( r, gen() % 2 == 0 );
+            }
+        }
+      Range folded = picked[0];
+      for ( size_t i = 1; i < picked.size(); ++i )
+        {
+          folded = folded.intersect( picked[i] );
+        }
+      const Range         swept = Range::intersect( picked );
+      std::vector<SemVer> witnesses;
+      for ( const Range & r : picked )
+        {
+          addWitnesses( r, witnesses );
+        }
+      for ( const SemVer & v : witnesses )
+        {
+          if ( swept.test( v ) != folded.test( v ) )
+            {
+              std::cerr << "range intersect all: " << v.version << std::endl;
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+range_intern()
+{
+  RangeInterner interner;
+  const Range   caret( "^1.2.0" );
+  auto          a = interner.intern( caret );
+  auto          b = interner.intern( Range( ">=1.2.0 <2.0.0-0" ) );
+  auto          c = interner.intern( Range( "1.x >=1.2.0" ) );
+  if ( ( a != b ) || ( a != c ) || ( interner.size() != 1 ) ||
+       ( caret.canonical().hash() != Range( "1.2 - 1" ).canonical().hash() )
+     )
+    {
+      std::cerr << "range intern: equivalent ranges" << std::endl;
+      return false;
+    }
+
+  /* Including pre-releases only matters if some are not already allowed. */
+  if ( ( interner.intern( Range( "1.x" ) ) ==
+         interner.intern( Range( "1.x", true ) )
+       ) ||
+       ( interner.intern( Range( "1.2.3-alpha - 1.2.3-beta" ) ) !=
+         interner.intern( Range( "1.2.3-alpha - 1.2.3-beta", true ) )
+       ) ||
+       ( ! a->test( SemVer( "1.5.0" ), false ) ) ||
+       a->test( SemVer( "1.5.0-rc.1" ), false )
+     )
+    {
+      std::cerr << "range intern: pre-releases" << std::endl;
+      return false;
+    }
+
+  /* Only the sets still referenced outside of the table are kept. */
+  if ( ( interner.collect() != 3 ) || ( interner.size() != 1 ) )
+    {
+      std::cerr << "range intern: collect" << std::endl;
+      return false;
+    }
+
+  /* Only the accepted versions matter, not pre-releases which are not. */
+  const std::vector<std::pair<std::string, std::string>> equivalent = {
+    { ">=1.2.0 <2.0.0", "^1.2.0" }, { "1.2.3 || 1.2.4", ">=1.2.3 <1.2.5-0" }
+  , { "<2.0.0", "<2.0.0-0" }
+  };
+  for ( const auto & [x, y] : equivalent )
+    {
+      const IntervalSet cx = Range( x ).canonical();
+      const IntervalSet cy = Range( y ).canonical();
+      if ( ( ! ( cx == cy ) ) || ( cx.hash() != cy.hash() ) ||
+           ( interner.intern( Range( x ) ) != interner.intern( Range( y ) ) )
+         )
+        {
+          std::cerr << "range intern: '" << x << "' and '" << y << "'"
+                    << std::endl;
+          return false;
+        }
+    }
+
+  /* Canonical forms are equal exactly when ranges accept the same versions. */
+  const std::vector<std::string> pool = rangePool( {
+    ">=1.2.3 <1.3.0-0", "~1.2.3", ">=0.0.0", ">=1.2.0 <2.0.0", "^1.2.0",
+    "1.2.3 || 1.2.4", ">=1.2.3 <1.2.5-0", "<2.0.0", "<2.0.0-0",
+    "1.2.3-alpha || 1.2.3-rc", "1.2.3-alpha || 1.2.3-rc - 1.2.4",
+    "1.2.3-alpha || 1.2.3-rc - 1.2.4 || >=1.2.4-0 <1.2.4"
+  } );
+  std::vector<Range> ranges;
+  for ( const std::string & r : pool )
+    {
+      ranges.emplace_back( r );
+      ranges.emplace_back( r, true );
+    }
+  for ( const Range & x : ranges )
+    {
+      /* Canonical forms are tested without including pre-releases. */
+      const IntervalSet   canonical = x.canonical();
+      std::vector<SemVer> own;
+      addWitnesses( x, own );
+      for ( const SemVer & v : own )
+        {
+          if ( canonical.test( v, false ) != x.test( v ) )
+            {
+              std::cerr << "range intern: '" << x.raw << "' canonical on "
+                        << v.version << std::endl;
+              return false;
+            }
+        }
+
+      for ( const Range & y : ranges )
+        {
+          std::vector<SemVer> witnesses;
+          addWitnesses( x, witnesses );
+          addWitnesses( y, witnesses );
+          const bool same = std::all_of(
+            witnesses.cbegin(), witnesses.cend()
+          , [&]( const SemVer & v ) { return x.test( v ) == y.test( v ); }
+          );
+          if ( same != ( x.canonical() == y.canonical() ) )
+            {
+              std::cerr << "range intern: '" << x.raw << "' and '" << y.raw
+                        << "'" << std::endl;
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+range_cache()
+{
+  RangeCache cache( 4, 1 );
+  auto       a = cache.get( "^1.2.3" );
+  auto       b = cache.get( "^1.2.3" );
+  auto       c = cache.get( "^1.2.3", true );
+  if ( ( a != b ) || ( a == c ) || ( ! c->includePrerelease ) ||
+       ( a->range != ">=1.2.3 <2.0.0-0" ) || ( cache.stats().hits != 1 ) ||
+       ( cache.stats().misses != 2 )
+     )
+    {
+      std::cerr << "range cache: lookup" << std::endl;
+      return false;
+    }
+
+  /* Invalid strings throw and are not cached. */
+  bool threw = false;
+  try { cache.get( ">=a.b.c" ); } catch ( const std::invalid_argument & ) {
+    threw = true;
+  }
+  if ( ( ! threw ) || ( cache.stats().size != 2 ) )
+    {
+      std::cerr << "range cache: invalid range" << std::endl;
+      return false;
+    }
+
+  /* Recently used entries survive a full shard, and evicted ones stay valid. */
+  cache.get( "~1.0.0" );
+  cache.get( "*" );
+  cache.get( "^1.2.3" );
+  cache.get( "1.x" );
+  if ( ( cache.stats().size != 4 ) || ( cache.get( "^1.2.3" ) != a ) ||
+       ( ! c->test( "1.5.0-rc.1" ) )
+     )
+    {
+      std::cerr << "range cache: eviction" << std::endl;
+      return false;
+    }
+
+  ComparatorCache comparators;
+  if ( ( comparators.get( ">=1.2.3" ) != comparators.get( ">=1.2.3" ) ) ||
+       ( ! comparators.get( ">=1.2.3" )->test( "1.3.0" ) )
+     )
+    {
+      std::cerr << "range cache: comparators" << std::endl;
+      return false;
+    }
+
+  /* Concurrent lookups agree on one shared range per string. */
+  const std::vector<std::string> pool = {
+    "^4.17.21", "*", "~1.0.0", "1.x || >=2.5.0", ">=1.2.3 <1.3.0-0", "1 - 2"
+  };
+  RangeCache                                             shared( 64, 4 );
+  std::vector<std::vector<std::shared_ptr<const Range>>> seen( 8 );
+  std::vector<std::thread>                               threads;
+  for ( size_t t = 0; t < seen.size(); ++t )
+    {
+      threads.emplace_back( [&, t]() {
+        for ( size_t i = 0; i < 1000; ++i )
+          {
+            seen[t].push_back( shared.get( pool[( t + i ) % pool.size()] ) );
+          }
+      } );
+    }
+  for ( std::thread & thread : threads )
+    {
+      thread.join();
+    }
+  for ( size_t t = 0; t < seen.size(); ++t )
+    {
+      for ( size_t i = 0; i < seen[t].size(); ++i )
+        {
+          if ( seen[t][i] != shared.get( pool[( t + i ) % pool.size()] ) )
+            {
+              std::cerr << "range cache: threads" << std::endl;
+              return false;
+            }
+        }
+    }
+  const RangeCache::Stats stats = shared.stats();
+  if ( ( stats.size != pool.size() ) ||
+       ( stats.hits + stats.misses != 2 * 8 * 1000 )
+     )
+    {
+      std::cerr << "range cache: counters" << std::endl;
+      return false;
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+range_test_columns()
+{
+  const std::vector<std::string> pool = rangePool( {
+    ">=4294967295.0.0", "0.0.x"
+  } );
+  std::vector<Range> ranges;
+  for ( const std::string & r : pool )
+    {
+      ranges.emplace_back( r );
+    }
+
+  /* Every bound, and pre-releases either side of them. */
+  const std::vector<SemVer> versions = poolWitnesses( pool, {
+    "1.2.3-alpha.0", "1.2.3-alpha.2", "1.2.3-zeta", "2.0.0-rc.10", "0.0.0-0",
+    "0.0.0", "1.2.3-0", "4294967295.4294967295.4294967295"
+  } );
+
+  for ( size_t n : { size_t( 0 ), size_t( 5 ), versions.size() } )
+    {
+      VersionColumns columns;
+      for ( size_t i = 0; i < n; ++i )
+        {
+          columns.push_back( versions[i] );
+        }
+      std::vector<uint64_t> matches( columns.maskWords() );
+      for ( const Range & r : ranges )
+        {
+          for ( bool includePrerelease : { false, true } )
+            {
+              r.test( columns, matches, includePrerelease );
+              for ( size_t i = 0; i < n; ++i )
+                {
+                  const bool bit = ( ( matches[i / 64] >> ( i % 64 ) ) & 1 );
+                  if ( bit != r.test( versions[i], includePrerelease ) )
+                    {
+                      std::cerr << "range test columns: '" << r.raw << "' "
+                                << versions[i].version << std::endl;
+                      return false;
+                    }
+                }
+            }
+        }
+    }
+
+  bool threw = false;
+  try
+    {
+      VersionColumns columns;
+      columns.push_back( SemVerView( "1.2.3" ) );
+      ranges[0].test( columns, std::span<uint64_t>() );
+    }
+  catch ( const std::invalid_argument & )
+    {
+      threw = true;
+    }
+  if ( ! threw )
+    {
+      std::cerr << "range test columns: small mask" << std::endl;
+      return false;
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+range_satisfying()
+{
+  struct SatisfyingCase {
+    std::vector<std::string> versions;
+    std::string              range;
+    std::string              max;
+    std::string              min;
+  };
+  /* From node-semver's tests, with sorted and empty cases. */
+  const std::vector<SatisfyingCase> cases = {
+    { { "1.2.3", "1.2.4" }, "1.2", "1.2.4", "1.2.3" }
+  , { { "1.2.4", "1.2.3" }, "1.2", "1.2.4", "1.2.3" }
+  , { { "1.2.3", "1.2.4", "1.2.5", "1.2.6" }, "~1.2.3", "1.2.6", "1.2.3" }
+  , { { "1.2.3", "1.2.4" }, "2.x", "", "" }
+  , { { "1.2.3-beta", "1.2.3", "1.2.4-alpha", "1.2.5-0" }, "^1.2.3-alpha"
+    , "1.2.3", "1.2.3-beta"
+    }
+  , { { "1.1.0", "2.0.0-rc.1", "2.0.0-rc.2" }, "<2.0.0 || 2.0.0-rc.1"
+    , "2.0.0-rc.1", "1.1.0"
+    }
+  , { {}, "*", "", "" }
+  };
+  for ( const SatisfyingCase & c : cases )
+    {
+      std::vector<SemVer> vs;
+      for ( const std::string & v : c.versions )
+        {
+          vs.emplace_back( v );
+        }
+      const Range    range( c.range );
+      const SemVer * max = maxSatisfying( vs, range );
+      const SemVer * min = minSatisfying( vs, range );
+      if ( ( ( max == nullptr ) ? "" : max->version ) != c.max ||
+           ( ( min == nullptr ) ? "" : min->version ) != c.min
+         )
+        {
+          std::cerr << "range satisfying: '" << c.range << "'" << std::endl;
+          return false;
+        }
+    }
+
+  struct MinVersionCase {
+    std::string range;
+    std::string min;
+  };
+  /* From node-semver's tests. */
+  const std::vector<MinVersionCase> minVersions = {
+    { "*", "0.0.0" }, { "* || >=2", "0.0.0" }, { ">=1.0.0", "1.0.0" }
+  , { ">1.0.0", "1.0.1" }, { "1.0.0 - 2.0.0", "1.0.0" }
+  , { "1.0.0 || 2.0.0", "1.0.0" }, { "<2.0.0", "0.0.0" }
+  , { ">1.0.0-alpha", "1.0.0-alpha.0" }, { "^1.0.0-alpha", "1.0.0-alpha" }
+  , { ">=1.0.0-0", "1.0.0-0" }, { ">2 || >1.0.0", "1.0.1" }
+  , { "<0.0.1-alpha", "0.0.0" }, { ">4 <3", "" }, { ">=0.0.0-0", "0.0.0-0" }
+  };
+  for ( const MinVersionCase & c : minVersions )
+    {
+      const std::optional<SemVer> min = minVersion( Range( c.range ) );
+      if ( ( min.has_value() ? min->version : "" ) != c.min )
+        {
+          std::cerr << "range min version: '" << c.range << "'" << std::endl;
+          return false;
+        }
+    }
+  if ( minVersion( Range( "*", true ) )->version != "0.0.0-0" )
+    {
+      std::cerr << "range min version: including pre-releases" << std::endl;
+      return false;
+    }
+
+  /* Binary searches of sorted versions agree with linear searches. */
+  const std::vector<std::string> pool   = rangePool();
+  std::vector<SemVer>            sorted = poolWitnesses( pool, {
+    "1.2.3-alpha.0", "1.2.3-zeta", "1.2.3+build"
+  } );
+  std::stable_sort( sorted.begin(), sorted.end()
+                  , []( const SemVer & a, const SemVer & b )
+                    {
+                      return a.compare( b ) < 0;
+                    }
+                  );
+  std::mt19937 gen( 16 );
+  for ( int round = 0; round < 50; ++round )
+    {
+      std::vector<SemVer> vs;
+      for ( const SemVer & v : sorted )
+        {
+          if ( gen() % 3 != 0 )
+            {
+              vs.push_back( v );
+            }
+        }
+      for ( const std::string & r : pool )
+        {
+          for ( bool includePrerelease : { false, true } )
+            {
+              const Range range( r, includePrerelease );
+              if ( ( maxSatisfying( vs, range ) !=
+                     maxSatisfyingSorted( vs, range )
+                   ) ||
+                   ( minSatisfying( vs, range ) !=
+                     minSatisfyingSorted( vs, range )
+                   )
+                 )
+                {
+                  std::cerr << "range satisfying sorted: '" << range.raw
+                            << "'" << std::endl;
+                  return false;
+                }
+              const std::optional<SemVer> min = minVersion( range );
+              if ( min.has_value() != ( ! range.compiled.acceptsNothing(
+                                          includePrerelease
+                                        ) ) ||
+                   ( min.has_value() && ( ! range.test( * min ) ) )
+                 )
+                {
+                  std::cerr << "range min version: '" << range.raw << "'"
+                            << std::endl;
+                  return false;
+                }
+            }
+        }
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+version_catalog()
+{
+  const std::vector<std::string> pool      = rangePool();
+  const std::vector<SemVer>      witnesses = poolWitnesses( pool, {
+    "1.2.3-alpha.0", "1.2.3-zeta", "1.2.3+build"
+  } );
+
+  std::mt19937 gen( 17 );
+  for ( int round = 0; round < 30; ++round )
+    {
+      /* Load half at once, and add the rest one or a few at a time. */
+      std::vector<SemVer> bulk;
+      std::vector<SemVer> rest;
+      for ( const SemVer & v : witnesses )
+        {
+          const unsigned pick = gen() % 4;
+          if ( pick == 0 )      { bulk.push_back( v ); }
+          else if ( pick == 1 ) { rest.push_back( v ); }
+        }
+      std::shuffle( bulk.begin(), bulk.end(), gen );
+      VersionCatalog catalog( bulk );
+      for ( size_t i = 0; i < rest.size(); ++i )
+        {
+          if ( i % 2 == 0 )
+            {
+              catalog.insert( rest[i] );
+            }
+          else
+            {
+              catalog.insert( std::vector<SemVer> { rest[i] } );
+            }
+        }
+
+      const std::span<const SemVer> all = catalog.versions();
+      if ( ! std::is_sorted( all.begin(), all.end()
+                           , []( const SemVer & a, const SemVer & b )
+                             {
+                               return a.compare( b ) < 0;
+                             }
+                           )
+         )
+        {
+          std::cerr << "version catalog: not sorted" << std::endl;
+          return false;
+        }
+
+      for ( const std::string & r : pool )
+        {
+          for ( bool includePrerelease : { false, true } )
+            {
+              const Range                   range( r, includePrerelease );
+              std::vector<const SemVer *>   expected;
+              for ( const SemVer & v : all )
+                {
+                  if ( range.test( v ) )
+                    {
+                      expected.push_back( & v );
+                    }
+                }
+              std::vector<const SemVer *>   matched;
+              const VersionCatalog::Matches matches = catalog.match( range );
+              for ( const SemVer & v : matches )
+                {
+                  matched.push_back( & v );
+                }
+              const SemVer * latest   = maxSatisfying( all, range );
+              const SemVer * earliest = minSatisfying( all, range );
+              if ( ( matched != expected ) ||
+                   ( matches.size() != expected.size() ) ||
+                   ( catalog.count( range ) != expected.size() ) ||
+                   ( matches.empty() != expected.empty() ) ||
+                   ( catalog.latest( range ) != latest ) ||
+                   ( catalog.earliest( range ) != earliest )
+                 )
+                {
+                  std::cerr << "version catalog: '" << range.raw << "'"
+                            << std::endl;
+                  return false;
+                }
+            }
+        }
+    }
+
+  /* Inserting into an empty catalog. */
+  VersionCatalog empty;
+  empty.insert( SemVer( "1.2.3" ) );
+  empty.insert( SemVer( "1.2.3-alpha" ) );
+  if ( ( empty.size() != 2 ) || ( empty.count( Range( "*" ) ) != 1 ) ||
+       ( empty.latest( Range( "*" ) ) != & empty[1] )
+     )
+    {
+      std::cerr << "version catalog: insert into empty" << std::endl;
+      return false;
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+concurrent_catalog()
+{
+  ConcurrentCatalog catalog;
+  {
+    /* A held snapshot is unaffected by later inserts, and keeps its
+     * catalog from being freed. */
+    ConcurrentCatalog::Snapshot before = catalog.snapshot();
+    catalog.insert( SemVer( "1.0.0" ) );
+    catalog.insert( std::vector<SemVer> { SemVer( "1.1.0" )
+                                        , SemVer( "1.1.0-rc.1" )
+                                        }
+                  );
+    if ( ( before->size() != 0 ) || ( catalog.snapshot()->size() != 3 ) ||
+         ( catalog.retired() != 2 )
+       )
+      {
+        std::cerr << "concurrent catalog: snapshot" << std::endl;
+        return false;
+      }
+  }
+  catalog.reclaim();
+  if ( catalog.retired() != 0 )
+    {
+      std::cerr << "concurrent catalog: reclaim" << std::endl;
+      return false;
+    }
+
+  /* Readers see whole, growing catalogs while a writer publishes. */
+  const Range              range( "^1.0.0" );
+  std::atomic<bool>        done { false };
+  std::atomic<bool>        failed { false };
+  std::vector<std::thread> readers;
+  for ( int t = 0; t < 4; ++t )
+    {
+      readers.emplace_back( [&]() {
+        size_t last = 0;
+        while ( ! done.load() )
+          {
+            ConcurrentCatalog::Snapshot snap = catalog.snapshot();
+            const size_t                n    = snap->size();
+            const SemVer *              top  = snap->latest( range );
+            /* Each publish adds one release, and one pre-release which is
+             * not accepted, to the three above. */
+            if ( ( n < last ) || ( n % 2 != 1 ) ||
+                 ( snap->count( range ) != ( n - 3 ) / 2 + 2 ) ||
+                 ( ( n > 3 ) && ( top->major != 1 ) )
+               )
+              {
+                failed.store( true );
+              }
+            last = n;
+          }
+      } );
+    }
+  for ( unsigned i = 0; i < 100; ++i )
+    {
+      catalog.insert( std::vector<SemVer> {
+        SemVer( "1.2." + std::to_string( i ) )
+      , SemVer( "1.2." + std::to_string( i ) + "-rc.1" )
+      } );
+    }
+  done.store( true );
+  for ( std::thread & reader : readers )
+    {
+      reader.join();
+    }
+  catalog.reclaim();
+  if ( failed.load() || ( catalog.retired() != 0 ) ||
+       ( catalog.snapshot()->latest( range )->version != "1.2.99" )
+     )
+    {
+      std::cerr << "concurrent catalog: stress" << std::endl;
+      return false;
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+compressed_catalog()
+{
+  const std::vector<std::string> pool      = rangePool();
+  const std::vector<SemVer>      witnesses = poolWitnesses( pool, {
+    "1.2.3-alpha.0", "1.2.3-zeta", "1.2.3+build.5",
+    "4294967295.4294967295.4294967295-x+y"
+  } );
+
+  std::mt19937 gen( 19 );
+  for ( int round = 0; round < 20; ++round )
+    {
+      /* Repeat versions so that catalogs span several blocks. */
+      std::vector<SemVer> vs;
+      for ( int copy = 0; copy < 4; ++copy )
+        {
+          for ( const SemVer & v : witnesses )
+            {
+              if ( gen() % 3 != 0 )
+                {
+                  vs.push_back( v );
+                }
+            }
+        }
+      std::shuffle( vs.begin(), vs.end(), gen );
+      const VersionCatalog    catalog( vs );
+      const CompressedCatalog compressed( catalog );
+
+      if ( compressed.size() != catalog.size() )
+        {
+          std::cerr << "compressed catalog: size" << std::endl;
+          return false;
+        }
+      for ( size_t i = 0; i < catalog.size(); ++i )
+        {
+          if ( compressed.at( i ).toString() != catalog[i].toString() ||
+               compressed.at( i ).build != catalog[i].build
+             )
+            {
+              std::cerr << "compressed catalog: at " << i << std::endl;
+              return false;
+            }
+        }
+
+      for ( const std::string & r : pool )
+        {
+          for ( bool includePrerelease : { false, true } )
+            {
+              const Range range( r, includePrerelease );
+              std::vector<std::string> expected;
+              for ( const SemVer & v : catalog.match( range ) )
+                {
+                  expected.push_back( v.toString() );
+                }
+              std::vector<std::string> matched;
+              for ( const SemVer & v : compressed.match( range ) )
+                {
+                  matched.push_back( v.toString() );
+                }
+              const SemVer *              latest   = catalog.latest( range );
+              const SemVer *              earliest = catalog.earliest( range );
+              const std::optional<SemVer> top      = compressed.latest( range );
+              const std::optional<SemVer> bottom   =
+                compressed.earliest( range );
+              if ( ( matched != expected ) ||
+                   ( compressed.count( range ) != expected.size() ) ||
+                   ( top.has_value() != ( latest != nullptr ) ) ||
+                   ( top.has_value() &&
+                     ( ( top->toString() != latest->toString() ) ||
+                       ( top->build != latest->build )
+                     )
+                   ) ||
+                   ( bottom.has_value() != ( earliest != nullptr ) ) ||
+                   ( bottom.has_value() &&
+                     ( bottom->toString() != earliest->toString() )
+                   )
+                 )
+                {
+                  std::cerr << "compressed catalog: '" << range.raw << "'"
+                            << std::endl;
+                  return false;
+                }
+            }
+        }
+    }
+
+  if ( ( CompressedCatalog().count( Range( "*" ) ) != 0 ) ||
+       CompressedCatalog().latest( Range( "*" ) ).has_value()
+     )
+    {
+      std::cerr << "compressed catalog: empty" << std::endl;
+      return false;
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+range_index()
+{
+  const std::vector<std::string> pool      = rangePool();
+  const std::vector<SemVer>      witnesses = poolWitnesses( pool );
+
+  RangeIndex                       index;
+  std::vector<Range>               ranges;
+  std::map<RangeIndex::Id, size_t> live;
+  std::mt19937                     gen( 20 );
+  for ( int round = 0; round < 20; ++round )
+    {
+      /* Register some ranges, and drop some others. */
+      for ( int i = 0; i < 10; ++i )
+        {
+          ranges.emplace_back( pool[gen() % pool.size()], gen() % 2 == 0 );
+          live[index.insert( ranges.back() )] = ranges.size() - 1;
+        }
+      for ( auto i = live.begin(); i != live.end(); )
+        {
+          if ( gen() % 4 == 0 )
+            {
+              index.erase( i->first );
+              i = live.erase( i );
+            }
+          else
+            {
+              ++i;
+            }
+        }
+      if ( index.size() != live.size() )
+        {
+          std::cerr << "range index: size" << std::endl;
+          return false;
+        }
+
+      for ( const SemVer & v : witnesses )
+        {
+          std::set<RangeIndex::Id> expected;
+          for ( const auto & [id, r] : live )
+            {
+              if ( ranges[r].test( v ) )
+                {
+                  expected.insert( id );
+                }
+            }
+          const std::vector<RangeIndex::Id> found = index.stab( v );
+          if ( ( found.size() != expected.size() ) ||
+               ( std::set<RangeIndex::Id>( found.begin(), found.end() ) !=
+                 expected
+               )
+             )
+            {
+              std::cerr << "range index: " << v.version << std::endl;
+              return false;
+            }
+        }
+    }
+
+  if ( index.erase( 1000000 ) )
+    {
+      std::cerr << "range index: erase" << std::endl;
+      return false;
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+catalog_bits()
+{
+  const std::vector<std::string> pool = rangePool( {
+    "<1.2.3 || >1.2.3", ">1.2.3-alpha <=1.2.3-beta.2", "1.2.3-alpha.1"
+  } );
+  std::vector<SemVer> witnesses = poolWitnesses( pool );
+  /* Pad past a word to exercise runs spanning several. */
+  for ( unsigned int i = 0; i < 100; ++i )
+    {
+      witnesses.emplace_back( "1." + std::to_string( i ) + ".0" );
+    }
+
+  const VersionCatalog catalog( witnesses );
+  CatalogBits          bits( catalog );
+  std::vector<Range>   ranges;
+  for ( const std::string & r : pool )
+    {
+      ranges.emplace_back( r );
+      ranges.emplace_back( r, true );
+    }
+  const std::vector<VersionBits> matrix = bits.matrix( ranges );
+  for ( size_t r = 0; r < ranges.size(); ++r )
+    {
+      for ( bool include : { false, true } )
+        {
+          const VersionBits accepted =
+            include ? bits.range( ranges[r], true ) : matrix[r];
+          size_t count = 0;
+          for ( size_t i = 0; i < catalog.size(); ++i )
+            {
+              const bool expected = ranges[r].test( catalog[i], include );
+              count += expected;
+              if ( accepted.test( i ) != expected )
+                {
+                  std::cerr << "catalog bits: " << ranges[r].range << " "
+                            << catalog[i].version << std::endl;
+                  return false;
+                }
+            }
+          if ( ( accepted.count() != count ) ||
+               ( accepted.positions().size() != count )
+             )
+            {
+              std::cerr << "catalog bits: count " << ranges[r].range
+                        << std::endl;
+              return false;
+            }
+        }
+    }
+
+  /* Comparators are shared across ranges. */
+  if ( bits.cached() >= 2 * pool.size() * 2 )
+    {
+      std::cerr << "catalog bits: cache" << std::endl;
+      return false;
+    }
+
+  const VersionCatalog empty;
+  CatalogBits          none( empty );
+  if ( none.range( Range( "*" ) ).count() != 0 )
+    {
+      std::cerr << "catalog bits: empty" << std::endl;
+      return false;
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+timed_catalog()
+{
+  /* Including equal versions, published at different times. */
+  const std::vector<std::string> pool      = rangePool();
+  const std::vector<SemVer>      witnesses = poolWitnesses( pool, {
+    "1.2.3+a", "1.2.3+b", "1.2.3-beta+c", "2.0.0+d"
+  } );
+
+  std::mt19937                         gen( 22 );
+  std::vector<TimedCatalog::Published> published;
+  for ( const SemVer & v : witnesses )
+    {
+      published.push_back( { v, TimedCatalog::Time( gen() % 100 ) } );
+    }
+  std::shuffle( published.begin(), published.end(), gen );
+
+  /* Load half at once, and add the rest one by one. */
+  const size_t half = published.size() / 2;
+  TimedCatalog timed( std::vector<TimedCatalog::Published>(
+    published.begin(), published.begin() + half
+  ) );
+  for ( size_t i = half; i < published.size(); ++i )
+    {
+      timed.insert( published[i].version, published[i].time );
+    }
+
+  const std::span<const SemVer> vs = timed.versions();
+  for ( size_t i = 1; i < vs.size(); ++i )
+    {
+      if ( 0 < vs[i - 1].compare( vs[i] ) )
+        {
+          std::cerr << "timed catalog: order" << std::endl;
+          return false;
+        }
+    }
+
+  for ( const std::string & r : pool )
+    {
+      for ( bool include : { false, true } )
+        {
+          const Range range( r );
+          for ( TimedCatalog::Time before : { 0, 1, 10, 50, 99, 100 } )
+            {
+              const SemVer * latest   = nullptr;
+              const SemVer * earliest = nullptr;
+              for ( size_t i = 0; i < vs.size(); ++i )
+                {
+                  if ( ( before <= timed.time( i ) ) ||
+                       ( ! range.test( vs[i], include ) )
+                     )
+                    {
+                      continue;
+                    }
+                  if ( ( latest == nullptr ) ||
+                       ( latest->compare( vs[i] ) < 0 )
+                     )
+                    {
+                      latest = & vs[i];
+                    }
+                  if ( earliest == nullptr )
+                    {
+                      earliest = & vs[i];
+                    }
+                }
+              if ( ( timed.latest( range, before, include ) != latest ) ||
+                   ( timed.earliest( range, before, include ) != earliest )
+                 )
+                {
+                  std::cerr << "timed catalog: " << r << " before " << before
+                            << std::endl;
+                  return false;
+                }
+            }
+        }
+    }
+
+  const TimedCatalog empty;
+  if ( empty.latest( Range( "*" ), 100 ) != nullptr )
+    {
+      std::cerr << "timed catalog: empty" << std::endl;
+      return false;
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+sort_versions()
+{
+  static const char * tags[] = { "alpha", "alpha.1", "alpha.beta", "beta.2"
+                               , "beta.11", "rc.1", "0", "1", "x-y"
+                               };
+  std::mt19937        gen( 23 );
+  std::vector<SemVer> input;
+  for ( int i = 0; i < 70000; ++i )
+    {
+      /* Mostly small parts, with some huge majors to set high key bits. */
+      std::string v = std::to_string( ( gen() % 50 == 0 ) ? gen() : gen() % 4 )
+                      + "." + std::to_string( gen() % 5 ) + "." +
+                      std::to_string( gen() % 5 );
+      if ( gen() % 2 == 0 )
+        {
+          v += std::string( "-" ) + tags[gen() % 9];
+        }
+      if ( gen() % 4 == 0 )
+        {
+          v += "+b." + std::to_string( gen() % 3 );
+        }
+      input.emplace_back( v );
+    }
+
+  auto less = []( const SemVer & a, const SemVer & b )
+    {
+      const char c = a.compare( b );
+      return ( c != 0 ) ? ( c < 0 ) : ( a.compareBuild( b ) < 0 );
+    };
+  for ( size_t n : { size_t( 0 ), size_t( 1 ), size_t( 1000 ), input.size() } )
+    {
+      for ( unsigned int threads : { 1u, 3u } )
+        {
+          std::vector<SemVer> want( input.begin(), input.begin() + n );
+          std::stable_sort( want.begin(), want.end(), less );
+          std::vector<SemVer> vs( input.begin(), input.begin() + n );
+          semi::sort( vs, threads );
+          for ( size_t i = 0; i < n; ++i )
+            {
+              /* Equal versions keep their input order. */
+              if ( vs[i].raw != want[i].raw )
+                {
+                  std::cerr << "sort: " << n << " at " << i << ": "
+                            << vs[i].raw << " " << want[i].raw << std::endl;
+                  return false;
+                }
+            }
+          semi::rsort( vs, threads );
+          for ( size_t i = 1; i < n; ++i )
+            {
+              if ( less( vs[i - 1], vs[i] ) )
+                {
+                  std::cerr << "rsort: " << n << " at " << i << std::endl;
+                  return false;
+                }
+            }
+        }
+    }
+
+  /* Equal versions keep their input order when reversed too. */
+  std::vector<SemVer> equal;
+  for ( const char * v : { "1.2.3", "v1.2.3", "2.0.0", "=1.2.3", "v2.0.0" } )
+    {
+      equal.emplace_back( v, false, true );
+    }
+  semi::rsort( equal );
+  const std::vector<std::string> descending = {
+    "2.0.0", "v2.0.0", "1.2.3", "v1.2.3", "=1.2.3"
+  };
+  for ( size_t i = 0; i < equal.size(); ++i )
+    {
+      if ( equal[i].raw != descending[i] )
+        {
+          std::cerr << "rsort: equal versions at " << i << ": "
+                    << equal[i].raw << std::endl;
+          return false;
+        }
+    }
+
+  std::vector<SemVer> vs = input;
+  semi::sort( vs );
+  const size_t kept = semi::unique( vs );
+  std::set<std::string> distinct;
+  for ( const SemVer & v : input )
+    {
+      distinct.insert( v.raw );
+    }
+  if ( kept != distinct.size() )
+    {
+      std::cerr << "unique: " << kept << " of " << distinct.size()
+                << std::endl;
+      return false;
+    }
+  for ( size_t i = 1; i < kept; ++i )
+    {
+      if ( ! less( vs[i - 1], vs[i] ) )
+        {
+          std::cerr << "unique: at " << i << std::endl;
+          return false;
+        }
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+hash_containers()
+{
+  /* Equal versions, ignoring build metadata, hash alike. */
+  const std::vector<std::pair<std::string, std::string>> same = {
+    { "1.2.3", "1.2.3+build.1" }, { "1.2.3-alpha.1", "1.2.3-alpha.1+b" }
+  , { "v1.2.3", "1.2.3" }, { "1.2.3-0", "1.2.3-0+0" }
+  };
+  for ( const auto & [a, b] : same )
+    {
+      const SemVer va( a, false, true );
+      const SemVer vb( b );
+      if ( ( ! ( va == vb ) ) || ( va.hash() != vb.hash() ) ||
+           ( SemVer::parseLazy( b ).hash() != va.hash() ) ||
+           ( SemVerView( b ).hash() != va.hash() )
+         )
+        {
+          std::cerr << "hash: " << a << " " << b << std::endl;
+          return false;
+        }
+    }
+  for ( const auto & [a, b] : std::vector<std::pair<std::string, std::string>> {
+          { "1.2.3", "1.2.4" }, { "1.2.3-alpha.1", "1.2.3-alpha.2" }
+        , { "1.2.3-alpha", "1.2.3" }, { "1.2.3-1", "1.2.3-a" }
+        } )
+    {
+      if ( SemVer( a ) == SemVer( b ) )
+        {
+          std::cerr << "hash: " << a << " == " << b << std::endl;
+          return false;
+        }
+    }
+  if ( ( ! ( SemVer( 1, 2 ) == SemVer( 1, 2 ) ) ) ||
+       ( SemVer( 1, 2 ) == SemVer( 1, 2, 0 ) )
+     )
+    {
+      std::cerr << "hash: partial versions" << std::endl;
+      return false;
+    }
+
+  std::unordered_set<SemVer> versions = { SemVer( "1.2.3+a" ) };
+  if ( ! versions.contains( SemVer( "1.2.3+b" ) ) )
+    {
+      std::cerr << "hash: std::hash<SemVer>" << std::endl;
+      return false;
+    }
+
+  /* Loose versions may pad numeric identifiers too long to decode. */
+  const SemVer    padded( "1.2.3-0123456789012345678901", false, true );
+  const SemVer    unpadded( "1.2.3-123456789012345678901" );
+  FlatSet<SemVer> saturated;
+  saturated.insert( unpadded );
+  if ( ( ! ( padded == unpadded ) ) || ( padded.hash() != unpadded.hash() ) ||
+       ( SemVerView( padded.raw, true ).hash() != unpadded.hash() ) ||
+       ( ! saturated.contains( padded ) )
+     )
+    {
+      std::cerr << "hash: padded numeric identifiers" << std::endl;
+      return false;
+    }
+
+  /* Comparators and ranges are equal if they are written alike. */
+  if ( ( ! ( Comparator( "=1.2.3" ) == Comparator( "1.2.3+b" ) ) ) ||
+       ( Comparator( "=1.2.3" ).hash() != Comparator( "1.2.3" ).hash() ) ||
+       ( Comparator( ">=1.2.3" ) == Comparator( ">1.2.3" ) ) ||
+       ( ! ( Comparator( "" ) == Range( "*" ).set[0][0] ) )
+     )
+    {
+      std::cerr << "hash: comparators" << std::endl;
+      return false;
+    }
+  if ( ( ! ( Range( "^1.2.3" ) == Range( ">=1.2.3 <2.0.0-0" ) ) ) ||
+       ( Range( "^1.2.3" ).hash() != Range( ">=1.2.3 <2.0.0-0" ).hash() ) ||
+       ( Range( "1.x || 2.x" ) == Range( "2.x || 1.x" ) ) ||
+       ( Range( "1.x" ) == Range( "1.x", true ) ) ||
+       ( Range( "1.2.3 2.0.0 || 3.0.0" ).hash() ==
+         Range( "1.2.3 || 2.0.0 3.0.0" ).hash()
+       )
+     )
+    {
+      std::cerr << "hash: ranges" << std::endl;
+      return false;
+    }
+
+  /* Deduplicate versions, and look them up by text. */
+  FlatSet<SemVer> set;
+  for ( int i = 0; i < 2000; ++i )
+    {
+      const std::string v = "1." + std::to_string( i % 500 ) + ".0" +
+                            ( ( i % 1000 < 500 ) ? "" : "+b" );
+      const auto [kept, added] = set.insert( SemVer( v ) );
+      if ( ( added != ( i < 500 ) ) || ( kept->raw.substr( 0, 2 ) != "1." ) )
+        {
+          std::cerr << "flat set: insert " << v << std::endl;
+          return false;
+        }
+    }
+  if ( ( set.size() != 500 ) || ( ! set.contains( "1.499.0+other" ) ) ||
+       set.contains( "1.500.0" ) || set.contains( "not a version" ) ||
+       ( set.find( "1.7.0" )->raw != "1.7.0" ) ||
+       ( ! set.contains( SemVer( "1.7.0" ) ) )
+     )
+    {
+      std::cerr << "flat set: find" << std::endl;
+      return false;
+    }
+  size_t n = 0;
+  for ( const SemVer & v : set )
+    {
+      if ( v.raw != "1." + std::to_string( n++ ) + ".0" )
+        {
+          std::cerr << "flat set: order" << std::endl;
+          return false;
+        }
+    }
+
+  FlatMap<Range, int> counts;
+  for ( const char * r : { "^1.2.3", ">=1.2.3 <2.0.0-0", "~1.2.3", "^1.2.3" } )
+    {
+      ++counts[Range( r )];
+    }
+  if ( ( counts.size() != 2 ) || ( counts.find( "^1.2.3" )->second != 3 ) ||
+       ( counts.find( ">=1.2.3 <1.3.0-0" )->second != 1 ) ||
+       counts.contains( "^2" ) || counts.contains( ">=>" )
+     )
+    {
+      std::cerr << "flat map" << std::endl;
+      return false;
+    }
+  counts.clear();
+  if ( ( ! counts.empty() ) || counts.contains( "^1.2.3" ) )
+    {
+      std::cerr << "flat map: clear" << std::endl;
+      return false;
+    }
+
+  return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  static bool
+version_pool()
+{
+  const std::vector<std::string> pool      = rangePool();
+  const std::vector<SemVer>      witnesses = poolWitnesses( pool );
+
+  /* Add versions in two batches, ranking between them. */
+  VersionPool                  versions;
+  std::vector<VersionPool::Id> ids;
+  const size_t                 half = witnesses.size() / 2;
+  for ( size_t i = 0; i < witnesses.size(); ++i )
+    {
+      if ( i == half )
+        {
+          versions.rank( 0 );
+        }
+      ids.push_back( versions.intern( witnesses[i] ) );
+    }
+  if ( ( versions.intern( "1.2.3+build" ) != versions.intern( "1.2.3" ) ) ||
+       ( versions.find( "1.2.3" ) != versions.find( SemVer( "1.2.3" ) ) ) ||
+       versions.find( "9.9.9" ).has_value() ||
+       versions.find( "not a version" ).has_value()
+     )
+    {
+      std::cerr << "version pool: intern" << std::endl;
+      return false;
+    }
+  for ( size_t i = 0; i < witnesses.size(); ++i )
+    {
+      if ( ( ! ( versions[ids[i]] == witnesses[i] ) ) ||
+           ( versions.intern( witnesses[i].toString() ) != ids[i] )
+         )
+        {
+          std::cerr << "version pool: id of " << witnesses[i].version
+                    << std::endl;
+          return false;
+        }
+    }
+
+  for ( VersionPool::Id a = 0; a < versions.size(); ++a )
+    {
+      if ( versions.byRank( versions.rank( a ) ) != a )
+        {
+          std::cerr << "version pool: byRank" << std::endl;
+          return false;
+        }
+      for ( VersionPool::Id b = 0; b < versions.size(); ++b )
+        {
+          if ( ( versions.rank( a ) < versions.rank( b ) ) !=
+               ( versions[a].compare( versions[b] ) < 0 )
+             )
+            {
+              std::cerr << "version pool: rank of " << versions[a].version
+                        << " and " << versions[b].version << std::endl;
+              return false;
+            }
+        }
+    }
+  if ( versions.generation() != 2 )
+    {
+      std::cerr << "version pool: generation" << std::endl;
+      return false;
+    }
+
+  for ( const std::string & r : pool )
+    {
+      const Range range( r );
+      for ( bool include : { false, true } )
+        {
+          const VersionPool::RankSet set = versions.compile( range, include );
+          for ( VersionPool::Id id = 0; id < versions.size(); ++id )
+            {
+              if ( set.test( versions.rank( id ) ) !=
+                   range.test( versions[id], include )
+                 )
+                {
+                  std::cerr << "version pool: " << r << " "
+                            << versions[id].version << std::endl;
+                  return false;
+                }
+            }
+        }
+      for ( const std::vector<Comparator> & comps : range.set )
+        {
+          for ( const Comparator & comp : comps )
+            {
+              const VersionPool::RankSet set = versions.compile( comp );
+              for ( VersionPool::Id id = 0; id < versions.size(); ++id )
+                {
+                  if ( set.test( versions.rank( id ) ) !=
+                       comp.test( versions[id] )
+                     )
+                    {
+                      std::cerr << "version pool: " << comp.value << " "
+                                << versions[id].version << std::endl;
+                      return false;
+                    }
+                }
+            }
+        }
+    }
+
+  return true;
+}
+
+
 /* -------------------------------------------------------------------------- */
 
   int
 main()
 {
-  if ( ! semver_class() ) { return 1; }
+  if ( ! semver_class() )   { return 1; }
+  if ( ! semver_scanner() ) { return 1; }
+  if ( ! semver_compare() ) { return 1; }
+  if ( ! compact_semver() ) { return 1; }
+  if ( ! semver_view() )    { return 1; }
+  if ( ! semver_lazy() )    { return 1; }
+  if ( ! string_compare() ) { return 1; }
+  if ( ! range_test() )     { return 1; }
+  if ( ! range_intersect() ) { return 1; }
+  if ( ! range_simplify() )  { return 1; }
+  if ( ! range_subset() )    { return 1; }
+  if ( ! range_intersect_all() ) { return 1; }
+  if ( ! range_intern() )        { return 1; }
+  if ( ! range_cache() )         { return 1; }
+  if ( ! range_test_columns() )  { return 1; }
+  if ( ! range_satisfying() )    { return 1; }
+  if ( ! version_catalog() )     { return 1; }
+  if ( ! concurrent_catalog() )  { return 1; }
+  if ( ! compressed_catalog() )  { return 1; }
+  if ( ! range_index() )         { return 1; }
+  if ( ! catalog_bits() )        { return 1; }
+  if ( ! timed_catalog() )       { return 1; }
+  if ( ! sort_versions() )       { return 1; }
+  if ( ! hash_containers() )     { return 1; }
+  if ( ! version_pool() )        { return 1; }
   return 0;
 }
 
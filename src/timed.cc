@@ -0,0 +1,185 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include "timed.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+static constexpr TimedCatalog::Time never =
+  std::numeric_limits<TimedCatalog::Time>::max();
+
+
+/* -------------------------------------------------------------------------- */
+
+TimedCatalog::TimedCatalog( std::vector<Published> published )
+{
+  std::stable_sort( published.begin(), published.end()
+                  , []( const Published & a, const Published & b )
+                    {
+                      return lessVersion( a.version, b.version );
+                    }
+                  );
+  std::vector<SemVer> versions;
+  versions.reserve( published.size() );
+  this->times.reserve( published.size() );
+  for ( Published & p : published )
+    {
+      versions.push_back( std::move( p.version ) );
+      this->times.push_back( p.time );
+    }
+  /* Already sorted, so the catalog's stable sort keeps times aligned. */
+  this->catalog = VersionCatalog( std::move( versions ) );
+  this->reindex();
+}
+
+
+  void
+TimedCatalog::insert( SemVer version, Time time )
+{
+  const std::span<const SemVer> versions = this->catalog.versions();
+  const size_t i = std::upper_bound( versions.begin(), versions.end()
+                                   , version, lessVersion
+                                   ) - versions.begin();
+  this->catalog.insert( std::move( version ) );
+  this->times.insert( this->times.begin() + i, time );
+  this->reindex();
+}
+
+
+  void
+TimedCatalog::reindex()
+{
+  this->leaves = 1;
+  while ( this->leaves < this->size() )
+    {
+      this->leaves *= 2;
+    }
+  this->earliestAll.assign( 2 * this->leaves, never );
+  this->earliestRelease.assign( 2 * this->leaves, never );
+  for ( size_t i = 0; i < this->size(); ++i )
+    {
+      this->earliestAll[this->leaves + i] = this->times[i];
+      if ( ( this->catalog[i].key & 1 ) != 0 )
+        {
+          this->earliestRelease[this->leaves + i] = this->times[i];
+        }
+    }
+  for ( size_t n = this->leaves - 1; 0 < n; --n )
+    {
+      this->earliestAll[n] = std::min( this->earliestAll[2 * n]
+                                     , this->earliestAll[2 * n + 1]
+                                     );
+      this->earliestRelease[n] = std::min( this->earliestRelease[2 * n]
+                                         , this->earliestRelease[2 * n + 1]
+                                         );
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+  size_t
+TimedCatalog::find( const std::vector<Time> & tree
+                  ,       size_t              begin
+                  ,       size_t              end
+                  ,       Time                before
+                  ,       bool                last
+                  ) const
+{
+  /* Descend from the root, visiting children nearest the wanted end first,
+   * so that only the subtrees straddling `begin' or `end' are split. */
+  struct Frame { size_t node; size_t lo; size_t hi; };
+  /* The stack holds at most one sibling per level, and the node popped. */
+  std::array<Frame, 2 * std::numeric_limits<size_t>::digits> stack;
+  size_t                                                      depth = 0;
+  stack[depth++] = Frame { 1, 0, this->leaves };
+  while ( depth != 0 )
+    {
+      const Frame f = stack[--depth];
+      if ( ( f.hi <= begin ) || ( end <= f.lo ) || ( before <= tree[f.node] ) )
+        {
+          continue;
+        }
+      if ( f.hi - f.lo == 1 )
+        {
+          return f.lo;
+        }
+      const size_t mid   = ( f.lo + f.hi ) / 2;
+      const Frame  left  = { 2 * f.node, f.lo, mid };
+      const Frame  right = { 2 * f.node + 1, mid, f.hi };
+      stack[depth++] = last ? left : right;
+      stack[depth++] = last ? right : left;
+    }
+  return this->size();
+}
+
+
+  const SemVer *
+TimedCatalog::latest( const Range & range
+                    ,       Time    before
+                    ,       bool    includePrerelease
+                    ) const
+{
+  const std::vector<VersionCatalog::Segment> segments =
+    this->catalog.match( range, includePrerelease ).segments;
+  for ( auto s = segments.crbegin(); s != segments.crend(); ++s )
+    {
+      const std::vector<Time> & tree = s->releasesOnly ? this->earliestRelease
+                                                       : this->earliestAll;
+      const size_t i = this->find( tree, s->begin, s->end, before, true );
+      if ( i == this->size() )
+        {
+          continue;
+        }
+      /* Prefer the first of the equal versions published in time. */
+      const std::span<const SemVer> versions = this->catalog.versions();
+      const size_t first = std::lower_bound( versions.begin()
+                                           , versions.begin() + i
+                                           , versions[i], lessVersion
+                                           ) - versions.begin();
+      return & versions[this->find( tree, first, i + 1, before, false )];
+    }
+  return nullptr;
+}
+
+
+  const SemVer *
+TimedCatalog::earliest( const Range & range
+                      ,       Time    before
+                      ,       bool    includePrerelease
+                      ) const
+{
+  for ( const VersionCatalog::Segment & s :
+          this->catalog.match( range, includePrerelease ).segments
+      )
+    {
+      const std::vector<Time> & tree = s.releasesOnly ? this->earliestRelease
+                                                      : this->earliestAll;
+      const size_t i = this->find( tree, s.begin, s.end, before, false );
+      if ( i != this->size() )
+        {
+          return & this->catalog[i];
+        }
+    }
+  return nullptr;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
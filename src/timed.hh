@@ -0,0 +1,141 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "catalog.hh"
+#include "range.hh"
+#include "semver.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * A catalog of versions and their publish times, answering "as of" queries
+ * such as the highest version accepted by a range which was published
+ * before some time, as `npm install --before' resolves.
+ *
+ * Versions are sorted as `VersionCatalog' sorts them, and their times kept
+ * in segment trees of minima, one over every version and one over releases
+ * only.
+ * A range's segments are searched from the end for the last position
+ * published in time, by descending into the subtrees whose minimum is, so
+ * that latest and earliest take O( k log n ) time for a range of k
+ * intervals.
+ */
+struct TimedCatalog {
+
+/* -------------------------------------------------------------------------- */
+
+    /** A publish time, in whatever unit and epoch callers agree on. */
+    using Time = int64_t;
+
+    struct Published {
+      SemVer version;
+      Time   time;
+    };
+
+
+/* -------------------------------------------------------------------------- */
+
+    TimedCatalog() = default;
+
+    /** Bulk load published versions in any order, sorting them once. */
+    explicit TimedCatalog( std::vector<Published> published );
+
+    /** Add one version, after any equal ones, in O( n ) time. */
+    void insert( SemVer version, Time time );
+
+    size_t size()  const { return this->times.size(); }
+    bool   empty() const { return this->times.empty(); }
+
+    /** Every version, in ascending order. */
+      std::span<const SemVer>
+    versions() const
+    {
+      return this->catalog.versions();
+    }
+
+    /** The publish time of the version at index `i'. */
+    Time time( size_t i ) const { return this->times[i]; }
+
+
+/* -------------------------------------------------------------------------- */
+
+    /* Queries, accepting versions as `Range::test' does. */
+
+    /**
+     * The highest version accepted by `range' which was published strictly
+     * before `before', or `nullptr' if there is none.
+     * The first of equal versions published in time is returned, as
+     * `maxSatisfying' does.
+     */
+      const SemVer *
+    latest( const Range & range
+          ,       Time    before
+          ,       bool    includePrerelease = false
+          ) const;
+
+    /** The lowest version accepted by `range' published before `before'. */
+      const SemVer *
+    earliest( const Range & range
+            ,       Time    before
+            ,       bool    includePrerelease = false
+            ) const;
+
+
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    VersionCatalog    catalog;
+    std::vector<Time> times;
+
+    /**
+     * Minimum times over every version, and over releases, as implicit
+     * binary trees over `leaves' positions, padded with the latest time.
+     */
+    std::vector<Time> earliestAll;
+    std::vector<Time> earliestRelease;
+    size_t            leaves = 0;
+
+    /** Rebuild the trees from `times'. */
+    void reindex();
+
+    /**
+     * The first or `last' position in [begin, end) of `tree' whose time is
+     * before `before', or `size()' if there is none.
+     */
+    size_t find( const std::vector<Time> & tree
+               ,       size_t              begin
+               ,       size_t              end
+               ,       Time                before
+               ,       bool                last
+               ) const;
+
+
+/* -------------------------------------------------------------------------- */
+
+};  /* End struct `TimedCatalog' */
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
@@ -0,0 +1,195 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <stdexcept>
+
+#include "view.hh"
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+  SemVerView::SemVerView( std::string_view version, bool loose )
+    : raw( version )
+  {
+    if ( ! scanSemVer( version, loose, this->parts ) )
+      {
+        throw std::invalid_argument(
+          "Invalid semantic version: '" + std::string( version ) + "'"
+        );
+      }
+  }
+
+
+    std::optional<SemVerView>
+  SemVerView::parse( std::string_view version, bool loose )
+  {
+    SemVerView rsl;
+    rsl.raw = version;
+    if ( ! scanSemVer( version, loose, rsl.parts ) )
+      {
+        return std::nullopt;
+      }
+    return rsl;
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    std::string
+  SemVerView::toString() const
+  {
+    std::string rsl = std::to_string( this->parts.major ) + "." +
+                      std::to_string( this->parts.minor ) + "." +
+                      std::to_string( this->parts.patch );
+    if ( ! this->parts.prerelease.empty() )
+      {
+        rsl += "-";
+        rsl += this->parts.prerelease;
+      }
+    return rsl;
+  }
+
+
+    SemVer
+  SemVerView::toSemVer( bool includePrerelease, bool loose ) const
+  {
+    SemVer rsl( this->parts.major, this->parts.minor, this->parts.patch
+              , splitIdentifiers( this->parts.prerelease )
+              , splitIdentifiers( this->parts.build )
+              );
+    rsl.raw               = this->raw;
+    rsl.includePrerelease = includePrerelease;
+    rsl.loose             = loose;
+    return rsl;
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    char
+  SemVerView::compare( const SemVerView & other ) const
+  {
+    const VersionKey a = this->key();
+    const VersionKey b = other.key();
+    if ( ( a != b ) || ( ( a & 1 ) != 0 ) )
+      {
+        return compareVersionKeys( a, b );
+      }
+    return compareIdentifiers( this->parts.prerelease
+                             , other.parts.prerelease
+                             );
+  }
+
+
+    char
+  SemVerView::compareMain( const SemVerView & other ) const
+  {
+    return compareVersionKeys( this->key() >> 1, other.key() >> 1 );
+  }
+
+
+    char
+  SemVerView::comparePre( const SemVerView & other ) const
+  {
+    return compareIdentifierLists( this->parts.prerelease
+                                 , other.parts.prerelease
+                                 );
+  }
+
+
+    char
+  SemVerView::compareBuild( const SemVerView & other ) const
+  {
+    return compareIdentifierLists( this->parts.build, other.parts.build );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+  /**
+   * The `SemVer' overloads expect `other' to have all of its main version
+   * parts set; unset parts are treated as zeroes.
+   */
+    char
+  SemVerView::compare( const SemVer & other ) const
+  {
+    const VersionKey a = this->key();
+    if ( ( a != other.key ) || ( ( a & 1 ) != 0 ) )
+      {
+        return compareVersionKeys( a, other.key );
+      }
+    return compareIdentifierLists( this->parts.prerelease
+                                 , other.prereleaseText()
+                                 );
+  }
+
+
+    char
+  SemVerView::compareMain( const SemVer & other ) const
+  {
+    return compareVersionKeys( this->key() >> 1, other.key >> 1 );
+  }
+
+
+    char
+  SemVerView::comparePre( const SemVer & other ) const
+  {
+    return compareIdentifierLists( this->parts.prerelease
+                                 , other.prereleaseText()
+                                 );
+  }
+
+
+    char
+  SemVerView::compareBuild( const SemVer & other ) const
+  {
+    /* Lazy versions have not split their build metadata yet. */
+    if ( other.lazy )
+      {
+        return this->compareBuild( SemVerView( other.raw, other.loose ) );
+      }
+    return compareIdentifierLists( this->parts.build, other.build );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+    std::optional<char>
+  compare( std::string_view a, std::string_view b, bool loose )
+  {
+    SemVerParts pa;
+    SemVerParts pb;
+    if ( ! ( scanSemVer( a, loose, pa ) && scanSemVer( b, loose, pb ) ) )
+      {
+        return std::nullopt;
+      }
+
+    if ( pa.major != pb.major )
+      {
+        return ( pa.major < pb.major ) ? -1 : 1;
+      }
+    if ( pa.minor != pb.minor )
+      {
+        return ( pa.minor < pb.minor ) ? -1 : 1;
+      }
+    if ( pa.patch != pb.patch )
+      {
+        return ( pa.patch < pb.patch ) ? -1 : 1;
+      }
+    return compareIdentifierLists( pa.prerelease, pb.prerelease );
+  }
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */
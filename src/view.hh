@@ -0,0 +1,214 @@
+/* ========================================================================== *
+ *
+ *
+ *
+ * -------------------------------------------------------------------------- */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string_view>
+
+#include "semver.hh"
+#include "scan.hh"
+
+/* -------------------------------------------------------------------------- */
+
+namespace semi {
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * A forward range over dot separated identifiers, yielding each one as a
+ * view into the underlying string.
+ */
+struct Identifiers {
+
+  std::string_view ids;
+
+  struct iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::string_view;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const std::string_view *;
+    using reference         = const std::string_view &;
+
+    /** The identifiers following the current one, without the dot. */
+    std::string_view rest;
+    std::string_view current;
+    bool             done;
+
+    reference operator*()  const { return this->current; }
+    pointer   operator->() const { return & this->current; }
+
+      iterator &
+    operator++()
+    {
+      if ( this->rest.data() == nullptr )
+        {
+          this->done = true;
+          return * this;
+        }
+      const size_t dot = this->rest.find( '.' );
+      this->current    = this->rest.substr( 0, dot );
+      this->rest       = ( dot == std::string_view::npos )
+                         ? std::string_view()
+                         : this->rest.substr( dot + 1 );
+      return * this;
+    }
+
+      iterator
+    operator++( int )
+    {
+      iterator tmp = * this;
+      ++( * this );
+      return tmp;
+    }
+
+      bool
+    operator==( const iterator & other ) const
+    {
+      return ( this->done == other.done ) &&
+             ( this->done || ( this->current.data() == other.current.data() ) );
+    }
+  };
+
+    iterator
+  begin() const
+  {
+    if ( this->ids.empty() )
+      {
+        return this->end();
+      }
+    iterator i { this->ids, {}, false };
+    return ++i;
+  }
+
+  iterator end()   const { return iterator { {}, {}, true }; }
+  bool     empty() const { return this->ids.empty(); }
+
+};  /* End struct `Identifiers' */
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * A parsed version which borrows its version string rather than copying it.
+ * The string must outlive the view, and constructing or comparing views never
+ * allocates.
+ */
+struct SemVerView {
+
+/* -------------------------------------------------------------------------- */
+
+    /* Data Members */
+
+    std::string_view raw;
+    SemVerParts      parts;
+
+
+/* -------------------------------------------------------------------------- */
+
+    /* Constructors */
+
+    /** Throws `std::invalid_argument' if `version' is not a valid version. */
+    SemVerView( std::string_view version, bool loose = false );
+
+    /** Returns `std::nullopt' if `version' is not a valid version. */
+      static std::optional<SemVerView>
+    parse( std::string_view version, bool loose = false );
+
+
+/* -------------------------------------------------------------------------- */
+
+    /* Accessors */
+
+    unsigned int major() const { return this->parts.major; }
+    unsigned int minor() const { return this->parts.minor; }
+    unsigned int patch() const { return this->parts.patch; }
+
+      VersionKey
+    key() const
+    {
+      return makeVersionKey( this->parts.major, this->parts.minor
+                           , this->parts.patch
+                           , ! this->parts.prerelease.empty()
+                           );
+    }
+
+    Identifiers prerelease() const { return { this->parts.prerelease }; }
+    Identifiers build()      const { return { this->parts.build }; }
+
+
+/* -------------------------------------------------------------------------- */
+
+    /* Serializers */
+
+    /** Render the version the way `SemVer::toString' does, omitting build. */
+    std::string toString() const;
+
+    SemVer toSemVer( bool includePrerelease = false
+                   , bool loose             = false
+                   ) const;
+
+
+/* -------------------------------------------------------------------------- */
+
+    /* Comparators */
+
+    char compare(      const SemVerView & other ) const;
+    char compareMain(  const SemVerView & other ) const;
+    char comparePre(   const SemVerView & other ) const;
+    char compareBuild( const SemVerView & other ) const;
+
+    char compare(      const SemVer & other ) const;
+    char compareMain(  const SemVer & other ) const;
+    char comparePre(   const SemVer & other ) const;
+    char compareBuild( const SemVer & other ) const;
+
+    /** The same hash as `SemVer::hash' gives an equal version. */
+      uint64_t
+    hash() const
+    {
+      return hashVersion( this->key(), this->parts.prerelease );
+    }
+
+
+/* -------------------------------------------------------------------------- */
+
+  private:
+
+    SemVerView() = default;
+
+
+/* -------------------------------------------------------------------------- */
+
+};  /* End struct `SemVerView' */
+
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Compare two version strings without constructing any versions, returning
+ * the same ordering as `SemVer::compare'.
+ * Both strings are scanned in full so that invalid input is reported, as
+ * `std::nullopt', but components are only compared up to the first one which
+ * differs.
+ */
+std::optional<char> compare( std::string_view a
+                           , std::string_view b
+                           , bool             loose = false
+                           );
+
+
+/* -------------------------------------------------------------------------- */
+
+}  /* End Namespace `semi' */
+
+/* -------------------------------------------------------------------------- *
+ *
+ *
+ *
+ * ========================================================================== */